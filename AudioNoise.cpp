@@ -17,9 +17,17 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 #include <limits>
 #include <complex>
 #include <bit>
-#include <memory>
 #include <tuple>
+#include <optional>
+#include <vector>
 #include <concepts>
+#include <span>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
@@ -28,6 +36,7 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 using byte = uint8_t;
 #include <exedit.hpp>
 #include "philox.hpp"
+#include "squares.hpp"
 #include "fft.hpp"
 
 
@@ -155,19 +164,56 @@ namespace noise
 	struct Exdata {
 		int32_t seed;
 		uint32_t fft_size; // bit-ceiling value is used.
+		// the fields below were appended after v1.10, whose data ends here.
+		// zero is the default of each, so the data saved without them loads as it did
+		// when the missing part is zero-filled or taken from `exdata_def`.
+		// any value out of range falls back to the default as well.
+		uint32_t method; // how the colored noise is generated.
+		uint32_t sampler; // how the normal random numbers are drawn.
+		uint32_t engine; // the generator of uniform random numbers.
+		uint32_t lookahead; // 1 to render the next frames ahead on a background thread.
 
 		constexpr static decltype(fft_size)
-			min_fft_size = 1u << 9, max_fft_size = 1u << 13;
+			min_fft_size = 1u << 9, max_fft_size = 1u << 20;
 		static constexpr auto clamp(decltype(fft_size) fft_size) {
 			return std::clamp(std::bit_ceil(fft_size), min_fft_size, max_fft_size);
 		}
 		constexpr auto clamped_fft_size() const { return clamp(fft_size); }
+
+		enum : decltype(method) {
+			method_fft,			// overlap-add of inverse FFTs of random spectra.
+			method_convolution,	// partitioned convolution of white noise.
+			method_sections,	// first-order recursive filters on white noise.
+			num_methods,
+		};
+		constexpr auto clamped_method() const { return method < num_methods ? method : method_fft; }
+
+		enum : decltype(sampler) {
+			sampler_box_muller,	// Box-Muller transform of pairs of uniform values.
+			sampler_ziggurat,	// rejection sampling by tables of layers.
+			num_samplers,
+		};
+		constexpr auto clamped_sampler() const { return sampler < num_samplers ? sampler : sampler_box_muller; }
+
+		enum : decltype(engine) {
+			engine_philox,		// Philox 4x32 with 10 rounds.
+			engine_philox_7,	// Philox 4x32 with 7 rounds.
+			engine_squares,		// Squares with 4 rounds.
+			num_engines,
+		};
+		constexpr auto clamped_engine() const { return engine < num_engines ? engine : engine_philox; }
+
+		constexpr decltype(lookahead) clamped_lookahead() const { return lookahead == 1 ? 1 : 0; }
 	};
-	constexpr Exdata exdata_def = { 0, 2048 };
+	constexpr Exdata exdata_def = { 0, 2048, Exdata::method_fft, Exdata::sampler_box_muller, Exdata::engine_philox, 0 };
 	constexpr ExEdit::ExdataUse exdata_use[] =
 	{
 		{.type = ExEdit::ExdataUse::Type::Number, .size = 4, .name = "seed" },
 		{.type = ExEdit::ExdataUse::Type::Number, .size = 4, .name = "fft_size" },
+		{.type = ExEdit::ExdataUse::Type::Number, .size = 4, .name = "method" },
+		{.type = ExEdit::ExdataUse::Type::Number, .size = 4, .name = "sampler" },
+		{.type = ExEdit::ExdataUse::Type::Number, .size = 4, .name = "engine" },
+		{.type = ExEdit::ExdataUse::Type::Number, .size = 4, .name = "lookahead" },
 	};
 
 	static_assert(sizeof(Exdata) == std::accumulate(
@@ -178,6 +224,10 @@ namespace noise
 		enum id : int {
 			seed,
 			fft_size,
+			method,
+			sampler,
+			engine,
+			lookahead,
 		};
 	};
 
@@ -472,8 +522,10 @@ static inline void update_window_state(int idx_detail, ExEdit::Filter* efp)
 	auto const* exdata = reinterpret_cast<noise::Exdata*>(efp->exdata_ptr);
 
 	// ボタン横のテキスト設定.
-	wchar_t text[std::bit_ceil(std::size(L"シード: -2147483648 / FFTサイズ: 8192****"))];
-	::swprintf_s(text, L"シード: %d / FFTサイズ: %d", exdata->seed, exdata->clamped_fft_size());
+	wchar_t text[std::bit_ceil(std::size(L"シード: -2147483648 / FFTサイズ: 1048576 / 方式: 1 / 正規乱数: 1 / 乱数器: 1 / 先読み: 1****"))];
+	::swprintf_s(text, L"シード: %d / FFTサイズ: %d / 方式: %d / 正規乱数: %d / 乱数器: %d / 先読み: %d",
+		exdata->seed, exdata->clamped_fft_size(), exdata->clamped_method(), exdata->clamped_sampler(), exdata->clamped_engine(),
+		exdata->clamped_lookahead());
 	::SetWindowTextW(efp->exfunc->get_hwnd(efp->processing, 5, idx_detail), text);
 }
 
@@ -495,6 +547,10 @@ static inline BOOL common_func_WndProc(int idx_detail, HWND hwnd, UINT message,
 			constexpr param_dialog_info info[] = {
 				{.const_3 = 3, .idx_use = idx_exdata::seed, .name = "シード" },
 				{.const_3 = 3, .idx_use = idx_exdata::fft_size, .name = "FFTサイズ" },
+				{.const_3 = 3, .idx_use = idx_exdata::method, .name = "方式" },
+				{.const_3 = 3, .idx_use = idx_exdata::sampler, .name = "正規乱数" },
+				{.const_3 = 3, .idx_use = idx_exdata::engine, .name = "乱数器" },
+				{.const_3 = 3, .idx_use = idx_exdata::lookahead, .name = "先読み" },
 
 				{.const_3 = 0, .idx_use = 0, .name = nullptr },
 			};
@@ -503,8 +559,12 @@ static inline BOOL common_func_WndProc(int idx_detail, HWND hwnd, UINT message,
 			auto prev = *exdata;
 			exedit.script_param_dialog(efp, info); // this function always returns TRUE.
 
-			// adjust fft_size into the acceptable range.
+			// adjust the fields into the acceptable range.
 			exdata->fft_size = Exdata::clamp(exdata->fft_size);
+			exdata->method = exdata->clamped_method();
+			exdata->sampler = exdata->clamped_sampler();
+			exdata->engine = exdata->clamped_engine();
+			exdata->lookahead = exdata->clamped_lookahead();
 
 			// 相違点があるなら「元に戻す」にデータ記録．
 			if (std::memcmp(&prev, exdata, sizeof(prev)) != 0) {
@@ -519,6 +579,14 @@ static inline BOOL common_func_WndProc(int idx_detail, HWND hwnd, UINT message,
 					exedit.update_any_exdata(efp->processing, exdata_use[idx_exdata::seed].name);
 				if (prev.fft_size != exdata->fft_size)
 					exedit.update_any_exdata(efp->processing, exdata_use[idx_exdata::fft_size].name);
+				if (prev.method != exdata->method)
+					exedit.update_any_exdata(efp->processing, exdata_use[idx_exdata::method].name);
+				if (prev.sampler != exdata->sampler)
+					exedit.update_any_exdata(efp->processing, exdata_use[idx_exdata::sampler].name);
+				if (prev.engine != exdata->engine)
+					exedit.update_any_exdata(efp->processing, exdata_use[idx_exdata::engine].name);
+				if (prev.lookahead != exdata->lookahead)
+					exedit.update_any_exdata(efp->processing, exdata_use[idx_exdata::lookahead].name);
 
 				update_window_state(idx_detail, efp);
 				return TRUE;
@@ -546,15 +614,52 @@ int32_t noise::func_window_init(HINSTANCE hinstance, HWND hwnd, int y, int base_
 ////////////////////////////////
 // 正規分布の乱数器．
 ////////////////////////////////
-template<std::floating_point base_float>
+// tables of the ziggurat method by Marsaglia and Tsang, with 256 layers.
+// layer 0 is the base strip including the tail, and the others are stacked up to the top layer 1.
+struct ziggurat_table {
+	constexpr static size_t layers = 256;
+	// a word is split into the layer index in the lower 8 bits and the signed magnitude in the rest,
+	// so that the two are independent.
+	constexpr static int mag_bits = 23;
+	constexpr static double
+		r = 3.6541528853610088,		// the start of the tail.
+		v = 4.92867323399e-3;		// the area of each layer.
+
+	uint32_t k[layers];	// the absolute magnitudes below these are inside the rectangle of each layer.
+	float w[layers];	// the scales from the magnitudes to the values.
+	double f[layers];	// \exp(-x^2/2) at the outer edge of each layer.
+
+	ziggurat_table()
+	{
+		constexpr double m = 1uLL << mag_bits;
+		double x = r, x_prev = r;
+		auto const q = v / std::exp(-x * x / 2);
+		k[0] = static_cast<uint32_t>(x / q * m); k[1] = 0;
+		w[0] = static_cast<float>(q / m); w[layers - 1] = static_cast<float>(x / m);
+		f[0] = 1; f[layers - 1] = std::exp(-x * x / 2);
+		for (size_t i = layers - 2; i > 0; i--) {
+			x = std::sqrt(-2 * std::log(v / x + std::exp(-x * x / 2)));
+			k[i + 1] = static_cast<uint32_t>(x / x_prev * m);
+			x_prev = x;
+			f[i] = std::exp(-x * x / 2);
+			w[i] = static_cast<float>(x / m);
+		}
+	}
+	static ziggurat_table const& get() { static ziggurat_table const ret{}; return ret; }
+};
+
+// `engine` is one of the generators of 32-bit uniform random numbers, with `generate()`.
+template<std::floating_point base_float, class engine>
 struct normal_rng {
-	constexpr normal_rng(uint32_t seed)
-		: core{ seed ^ philox::default_seed }
-		, r{ nan } {}
+	constexpr normal_rng(uint32_t seed, bool ziggurat = false)
+		: core{ seed ^ engine::default_seed }
+		, r{ nan }, count{ 0 }
+		, key{ ziggurat ? seed | (1uLL << 32) : 0 } {}
 
 	// returns a random number according to the normal distribution.
 	// std dev is 1 and mean is 0.
 	constexpr base_float operator()() {
+		if (key != 0) return ziggurat();
 		if (!std::isnan(r)) return std::exchange(r, nan);
 
 		auto a = core() / N, b = core() / N;
@@ -563,25 +668,242 @@ struct normal_rng {
 		r = static_cast<base_float>(b * std::sin(a));
 		return static_cast<base_float>(b * std::cos(a));
 	}
+	// both of the methods consume a single word of `core` per value on average,
+	// and the ziggurat method exactly so.
 	constexpr void discard(uint_fast64_t n) {
 		if (n == 0) return;
+		if (key != 0) {
+			count += n;
+			core.discard(n);
+			return;
+		}
 		if (!std::isnan(r)) { r = nan; n--; }
 		core.discard(n & (~1uLL));
 		if ((n & 1u) != 0) (*this)();
 	}
+	// fills `dst` with the values that the same number of calls to operator() would return.
+	// the Box-Muller transform is evaluated in float by polynomial approximations,
+	// so the values may differ from those of operator() by a few ulps.
+	void fill(std::span<base_float> dst) {
+		if (key != 0 || !std::same_as<base_float, float>) {
+			for (auto& x : dst) x = (*this)();
+			return;
+		}
+
+		size_t k = 0;
+		auto const len = dst.size();
+		if (k < len && !std::isnan(r)) dst[k++] = std::exchange(r, nan);
+		while (len - k >= 2) {
+			typename engine::result_type words[2 * fill_pairs];
+			auto const pairs = std::min((len - k) / 2, fill_pairs);
+			core.generate({ words, 2 * pairs });
+			box_muller(reinterpret_cast<float*>(dst.data() + k), words, pairs);
+			k += 2 * pairs;
+		}
+		if (k < len) dst[k] = (*this)();
+	}
 
 private:
-	using philox = sigma_lib::rng::philox_test::philox4x32;
-	philox core;
+	engine core;
 	base_float r;
+	uint_fast64_t count; // number of values drawn by the ziggurat method.
+	uint64_t key; // nonzero for the ziggurat method.
 	constexpr static base_float
 		nan = std::numeric_limits<base_float>::quiet_NaN();
 	constexpr static double
 		pi	= std::numbers::pi_v<double>,
-		N	= static_cast<double>(philox::max()) + 1;
+		N	= static_cast<double>(engine::max()) + 1;
+	static_assert(std::numeric_limits<typename engine::result_type>::digits == 32);
 	static_assert(
 		std::numeric_limits<decltype(N)>::digits >=
-		std::numeric_limits<philox::result_type>::digits); // log(1 - b) could be $-\infty$ otherwise.
+		std::numeric_limits<typename engine::result_type>::digits); // log(1 - b) could be $-\infty$ otherwise.
+
+	// the Box-Muller transform in float for `fill()`.
+	// each pair takes the angle from the first word and the radius from the second,
+	// in the same way as operator().
+	constexpr static size_t fill_pairs = 64;
+	constexpr static uint32_t
+		// 1 - k / 2^32 \geq \sqrt{1/2} for the words k up to this.
+		log_small = 0x4afb0cccu;
+	constexpr static float
+		sqrt_half = 0.70710678f,
+		ln2_hi = 0.693359375f, ln2_lo = -2.12194440e-4f,
+		two_pi_32 = static_cast<float>(2 * pi / N);
+	// coefficients of log(1 + f) on [\sqrt{1/2} - 1, \sqrt{2} - 1],
+	// and of sin and cos on [-\pi/4, \pi/4] (from Cephes).
+	constexpr static float log_coef[] = {
+		7.0376836292e-2f, -1.1514610310e-1f, 1.1676998740e-1f,
+		-1.2420140846e-1f, 1.4249322787e-1f, -1.6668057665e-1f,
+		2.0000714765e-1f, -2.4999993993e-1f, 3.3333331174e-1f,
+	};
+	constexpr static float
+		sin_coef[] = { -1.9515295891e-4f, 8.3321608736e-3f, -1.6666654611e-1f },
+		cos_coef[] = { 2.443315711809948e-5f, -1.388731625493765e-3f, 4.166664568298827e-2f };
+
+	static void box_muller(float* dst, typename engine::result_type const* words, size_t pairs)
+	{
+#ifdef SIGMA_LIB_PHILOX_SSE2
+		if constexpr (sizeof(typename engine::result_type) == sizeof(uint32_t)) {
+			for (; pairs >= 4; pairs -= 4, dst += 8, words += 8) {
+				auto const
+					w0 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(words))),
+					w1 = _mm_castsi128_ps(_mm_loadu_si128(reinterpret_cast<__m128i const*>(words + 4)));
+				auto const
+					a = _mm_castps_si128(_mm_shuffle_ps(w0, w1, _MM_SHUFFLE(2, 0, 2, 0))),
+					b = _mm_castps_si128(_mm_shuffle_ps(w0, w1, _MM_SHUFFLE(3, 1, 3, 1)));
+				__m128 c, s;
+				sincos_simd(c, s, a);
+				auto const rad = _mm_sqrt_ps(_mm_mul_ps(_mm_set1_ps(-2.0f), log_simd(b)));
+				c = _mm_mul_ps(rad, c); s = _mm_mul_ps(rad, s);
+				_mm_storeu_ps(dst, _mm_unpacklo_ps(c, s));
+				_mm_storeu_ps(dst + 4, _mm_unpackhi_ps(c, s));
+			}
+		}
+#endif
+		for (; pairs > 0; pairs--, dst += 2, words += 2) {
+			auto const [c, s] = sincos_float(static_cast<uint32_t>(words[0]));
+			auto const rad = std::sqrt(-2.0f * log_float(static_cast<uint32_t>(words[1])));
+			dst[0] = rad * c; dst[1] = rad * s;
+		}
+	}
+
+	// log(1 - k / 2^32), keeping the relative precision at both ends.
+	static float log_float(uint32_t k)
+	{
+		float f, e = 0;
+		if (k <= log_small)
+			// 1 - k / 2^32 = 1 + f exactly.
+			f = -static_cast<float>(static_cast<int32_t>(k)) * 0x1p-32f;
+		else {
+			// split into the exponent and the mantissa in [\sqrt{1/2}, \sqrt{2}).
+			auto const j = ~k;
+			auto const u = (static_cast<float>(static_cast<int32_t>(j >> 1)) * 2
+				+ static_cast<float>(static_cast<int32_t>((j & 1) + 1))) * 0x1p-32f;
+			auto const bits = std::bit_cast<uint32_t>(u);
+			auto m = std::bit_cast<float>((bits & 0x807fffffu) | 0x3f000000u);
+			e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 126);
+			if (m < sqrt_half) { e -= 1; m += m; }
+			f = m - 1;
+		}
+		auto const z = f * f;
+		float y = log_coef[0];
+		for (size_t i = 1; i < std::size(log_coef); i++) y = y * f + log_coef[i];
+		y = y * f * z + e * ln2_lo - 0.5f * z;
+		return f + y + e * ln2_hi;
+	}
+	// cos and sin of 2\pi k / 2^32.
+	static std::pair<float, float> sincos_float(uint32_t k)
+	{
+		// reduce to [-\pi/4, \pi/4) by the quadrant n.
+		auto const n = (k + (1u << 29)) >> 30;
+		auto const x = static_cast<float>(static_cast<int32_t>(k - (n << 30))) * two_pi_32, z = x * x;
+		auto const
+			s = ((sin_coef[0] * z + sin_coef[1]) * z + sin_coef[2]) * z * x + x,
+			c = ((cos_coef[0] * z + cos_coef[1]) * z + cos_coef[2]) * z * z - 0.5f * z + 1.0f;
+		switch (n) {
+		case 0: return { c, s };
+		case 1: return { -s, c };
+		case 2: return { -c, -s };
+		default: return { s, -c };
+		}
+	}
+#ifdef SIGMA_LIB_PHILOX_SSE2
+	static __m128 log_simd(__m128i k)
+	{
+		// the lanes of small k.
+		auto const sign = _mm_set1_epi32(static_cast<int32_t>(0x80000000u));
+		auto const small = _mm_castsi128_ps(_mm_cmplt_epi32(_mm_xor_si128(k, sign),
+			_mm_set1_epi32(static_cast<int32_t>((log_small + 1) ^ 0x80000000u))));
+		auto const f_small = _mm_mul_ps(_mm_cvtepi32_ps(k), _mm_set1_ps(-0x1p-32f));
+
+		// the other lanes.
+		auto const j = _mm_xor_si128(k, _mm_set1_epi32(-1));
+		auto const u = _mm_mul_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(j, 1)), _mm_set1_ps(2.0f)),
+			_mm_cvtepi32_ps(_mm_add_epi32(_mm_and_si128(j, _mm_set1_epi32(1)), _mm_set1_epi32(1)))),
+			_mm_set1_ps(0x1p-32f));
+		auto const bits = _mm_castps_si128(u);
+		auto m = _mm_castsi128_ps(_mm_or_si128(
+			_mm_and_si128(bits, _mm_set1_epi32(0x807fffff)), _mm_set1_epi32(0x3f000000)));
+		auto e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+		auto const lt = _mm_cmplt_ps(m, _mm_set1_ps(sqrt_half));
+		e = _mm_sub_ps(e, _mm_and_ps(lt, _mm_set1_ps(1.0f)));
+		m = _mm_add_ps(m, _mm_and_ps(lt, m));
+		auto const f_large = _mm_sub_ps(m, _mm_set1_ps(1.0f));
+
+		auto const f = _mm_or_ps(_mm_and_ps(small, f_small), _mm_andnot_ps(small, f_large));
+		e = _mm_andnot_ps(small, e);
+		auto const z = _mm_mul_ps(f, f);
+		auto y = _mm_set1_ps(log_coef[0]);
+		for (size_t i = 1; i < std::size(log_coef); i++)
+			y = _mm_add_ps(_mm_mul_ps(y, f), _mm_set1_ps(log_coef[i]));
+		y = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(y, f), z), _mm_mul_ps(e, _mm_set1_ps(ln2_lo))),
+			_mm_mul_ps(_mm_set1_ps(0.5f), z));
+		return _mm_add_ps(_mm_add_ps(f, y), _mm_mul_ps(e, _mm_set1_ps(ln2_hi)));
+	}
+	static void sincos_simd(__m128& cos, __m128& sin, __m128i k)
+	{
+		auto const n = _mm_srli_epi32(_mm_add_epi32(k, _mm_set1_epi32(1 << 29)), 30);
+		auto const x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_sub_epi32(k, _mm_slli_epi32(n, 30))), _mm_set1_ps(two_pi_32));
+		auto const z = _mm_mul_ps(x, x);
+		auto s = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(sin_coef[0]), z), _mm_set1_ps(sin_coef[1])), z), _mm_set1_ps(sin_coef[2])), z), x), x);
+		auto c = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(
+			_mm_mul_ps(_mm_set1_ps(cos_coef[0]), z), _mm_set1_ps(cos_coef[1])), z), _mm_set1_ps(cos_coef[2])), z), z),
+			_mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+
+		// rotate by the quadrant; swap for odd n, and flip the signs.
+		auto const odd = _mm_castsi128_ps(_mm_cmpeq_epi32(
+			_mm_and_si128(n, _mm_set1_epi32(1)), _mm_set1_epi32(1)));
+		auto const c1 = _mm_or_ps(_mm_and_ps(odd, s), _mm_andnot_ps(odd, c)),
+			s1 = _mm_or_ps(_mm_and_ps(odd, c), _mm_andnot_ps(odd, s));
+		auto const two = _mm_set1_epi32(2);
+		cos = _mm_xor_ps(c1, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(_mm_add_epi32(n, _mm_set1_epi32(1)), two), 30)));
+		sin = _mm_xor_ps(s1, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(n, two), 30)));
+	}
+#endif
+
+	// the rare rejected cases draw further words from a hash of the index,
+	// so that each value takes exactly one word of `core` and `discard()` stays cheap.
+	base_float ziggurat()
+	{
+		using zt = ziggurat_table;
+		auto const& tbl = zt::get();
+		auto const idx = count++;
+		uint32_t word = static_cast<uint32_t>(core());
+		for (uint64_t sub = 0;; word = static_cast<uint32_t>(hash(idx, ++sub) >> 32)) {
+			auto const i = word & (zt::layers - 1);
+			auto const mag = static_cast<int32_t>(word) >> (31 - zt::mag_bits);
+
+			// the sign is carried by the magnitude to avoid unpredictable branches.
+			base_float x = mag * tbl.w[i];
+			if (static_cast<uint32_t>(std::abs(mag)) < tbl.k[i]) return x;
+			if (i == 0) {
+				// the tail beyond r.
+				double t, s;
+				do {
+					t = -std::log(uniform(idx, ++sub)) / zt::r;
+					s = -std::log(uniform(idx, ++sub));
+				} while (s + s < t * t);
+				return static_cast<base_float>(mag < 0 ? -(zt::r + t) : zt::r + t);
+			}
+			// the wedge between the rectangle and the curve.
+			if (tbl.f[i] + uniform(idx, ++sub) * (tbl.f[i - 1] - tbl.f[i])
+				< std::exp(-double{ x } * x / 2)) return x;
+		}
+	}
+	constexpr uint64_t hash(uint64_t idx, uint64_t sub) const {
+		auto mix = [](uint64_t z) {
+			z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9uLL;
+			z = (z ^ (z >> 27)) * 0x94d049bb133111ebuLL;
+			return z ^ (z >> 31);
+		};
+		return mix(mix(idx * 0x9e3779b97f4a7c15uLL ^ key) + sub);
+	}
+	// uniform in (0, 1].
+	constexpr double uniform(uint64_t idx, uint64_t sub) const {
+		return ((hash(idx, sub) >> 11) + 1) * 0x1p-53;
+	}
 };
 
 
@@ -592,154 +914,927 @@ struct colored_noise {
 	constexpr static size_t max_fft_size = noise::Exdata::max_fft_size;
 
 protected:
-	// maximum size is doubled to make use of the cached sin/cos table.
-	using FFT = sigma_lib::fft::FFT<2 * max_fft_size, float>;
-	static inline std::unique_ptr<FFT> fft{};
-	static void init_fft() { if (!fft) fft = std::make_unique<FFT>(); }
+	// sizes up to 8192 use the tables directly,
+	// and larger ones are composed of these by the four-step algorithm.
+	using FFT = sigma_lib::fft::FFT<(1u << 13), float>;
+	static_assert(max_fft_size <= FFT::max_size * FFT::max_size);
+	// the tables are computed at compile time and placed in read-only data.
+	constexpr static FFT fft{};
+	// the transforms of length `fft_size`, with the tilting factors \e(i/(2 fft_size)).
+	// the plans for sizes larger than `FFT::max_size` allocate their scratch on the first use,
+	// so each thread has its own plans.
+	static FFT::plan const& plan(uint32_t fft_size)
+	{
+		auto& ret = plans[std::countr_zero(fft_size)];
+		if (!ret) ret.emplace(fft.make_plan(fft_size, column_pool::lanes()));
+		return *ret;
+	}
+	static inline thread_local std::optional<FFT::plan> plans[std::bit_width(max_fft_size)]{};
+
+	// splits the column transforms of the four-step algorithm, used for the sizes larger than
+	// `FFT::max_size`, among the threads. each group of columns is transformed the same way
+	// on whichever thread, so the values are identical to those of the serial loop.
+	// the calling thread works as the lane 0, and a second caller meanwhile runs serially.
+	class column_pool {
+		std::mutex turn{}, mtx{};
+		std::condition_variable start{}, done{};
+		void (*job)(void const*, size_t, size_t) = nullptr;
+		void const* ctx = nullptr;
+		size_t count = 0, busy = 0;
+		uint64_t round = 0;
+		std::atomic<size_t> next{ 0 };
+
+		// never destroyed; the workers are gone at the process exit,
+		// and neither joining them under the loader lock nor destroying the waited primitives is safe.
+		column_pool()
+		{
+			for (size_t lane = 1; lane < lanes(); lane++)
+				std::thread{ [this, lane] { work(lane); } }.detach();
+		}
+
+		void drain(size_t lane)
+		{
+			for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+				job(ctx, i, lane);
+		}
+		void work(size_t lane)
+		{
+			uint64_t seen = 0;
+			std::unique_lock lock{ mtx };
+			while (true) {
+				start.wait(lock, [&] { return round != seen; });
+				seen = round;
+				lock.unlock();
+				drain(lane);
+				lock.lock();
+				if (--busy == 0) done.notify_one();
+			}
+		}
+
+	public:
+		// up to 8 threads, with the scratch of 64 KiB each at the largest size.
+		static size_t lanes()
+		{
+			static size_t const n = std::clamp<size_t>(std::thread::hardware_concurrency(), 1, 8);
+			return n;
+		}
+
+		// the `columns` loop of `FFT::plan`; calls `f(i, lane)` for `i < n`.
+		static void run(size_t n, auto&& f)
+		{
+			if (lanes() > 1 && n > 1) {
+				static auto& self = *new column_pool{};
+				if (std::unique_lock turn{ self.turn, std::try_to_lock }) {
+					{
+						std::lock_guard lock{ self.mtx };
+						self.job = [](void const* c, size_t i, size_t lane) {
+							(*static_cast<std::remove_reference_t<decltype(f)> const*>(c))(i, lane);
+						};
+						self.ctx = &f;
+						self.count = n;
+						self.next.store(0, std::memory_order_relaxed);
+						self.busy = lanes() - 1;
+						self.round++;
+					}
+					self.start.notify_all();
+					self.drain(0);
+
+					std::unique_lock lock{ self.mtx };
+					self.done.wait(lock, [&] { return self.busy == 0; });
+					return;
+				}
+			}
+			for (size_t i = 0; i < n; i++) f(i, 0);
+		}
+	};
+	constexpr static auto columns = [](size_t n, auto&& f) { column_pool::run(n, f); };
+
+	// block length of the partitioned convolution, whose kernel is of length `fft_size`.
+	// the number of partitions is limited to 64 for large sizes.
+	constexpr static uint32_t conv_block(uint32_t fft_size) { return std::max(256u, fft_size / 64); }
 
 	static FFT::cpx* fft_buf() { return reinterpret_cast<FFT::cpx*>(memory_ptr); }
-	static float* wt_tbl(uint32_t fft_size) { return reinterpret_cast<float*>(fft_buf() + 2 * fft_size); }
+	static float* out_buf(uint32_t fft_size) { return reinterpret_cast<float*>(fft_buf() + fft_size); }
 
-	static void prepare_weight_table(uint32_t fft_size, float alpha, float scale)
+	// log(0.5 + i) for the first `n` bins, common to all the sizes.
+	static float const* log_bins(size_t n)
 	{
-		auto const wt = wt_tbl(fft_size);
+		if (auto const i0 = log_bin_tbl.size(); i0 < n) {
+			log_bin_tbl.resize(n);
+			for (size_t i = i0; i < n; i++) log_bin_tbl[i] = std::log(0.5f + i);
+		}
+		return log_bin_tbl.data();
+	}
 
-		// pre-calculate the bias of the colored noise.
-		float power = 0;
-		for (size_t i = 0; i < fft_size / 2; i++) {
-			auto const r = std::pow(0.5f + i, -alpha / 2);
-			wt[i] = r;
-			power += r * r;
+	// writes exp(c x[i]) for `n` values to `dst`, and returns the sum of their squares.
+	// assumes the results are within the normal range of float.
+	static float exp_scaled(float* dst, float const* x, float c, size_t n)
+	{
+		size_t i = 0;
+		float sum = 0;
+#ifdef SIGMA_LIB_PHILOX_SSE2
+		auto const vc = _mm_set1_ps(c);
+		auto acc = _mm_setzero_ps();
+		for (; i + 4 <= n; i += 4) {
+			// exp(y) = 2^k exp(r), where |r| \leq \ln 2 / 2.
+			auto const y = _mm_mul_ps(vc, _mm_loadu_ps(x + i));
+			auto const k = _mm_cvtps_epi32(_mm_mul_ps(y, _mm_set1_ps(log2e)));
+			auto const fk = _mm_cvtepi32_ps(k);
+			auto const r = _mm_sub_ps(_mm_sub_ps(y, _mm_mul_ps(fk, _mm_set1_ps(ln2_hi))),
+				_mm_mul_ps(fk, _mm_set1_ps(ln2_lo)));
+			auto z = _mm_set1_ps(exp_coef[0]);
+			for (size_t j = 1; j < std::size(exp_coef); j++)
+				z = _mm_add_ps(_mm_mul_ps(z, r), _mm_set1_ps(exp_coef[j]));
+			z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(z, r), r), r), _mm_set1_ps(1.0f));
+			auto const v = _mm_castsi128_ps(_mm_add_epi32(_mm_castps_si128(z), _mm_slli_epi32(k, 23)));
+			_mm_storeu_ps(dst + i, v);
+			acc = _mm_add_ps(acc, _mm_mul_ps(v, v));
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, acc);
+		sum = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+#endif
+		for (; i < n; i++) {
+			auto const v = std::exp(c * x[i]);
+			dst[i] = v;
+			sum += v * v;
+		}
+		return sum;
+	}
+
+	// the weight table of length `fft_size / 2` for the parameters,
+	// calculated unless it's one of the recently used.
+	// the tables are never modified once made, and each user holds its own reference,
+	// so a table evicted from the recent ones stays valid for those still using it.
+	static std::shared_ptr<float const[]> weight_table(uint32_t fft_size, float alpha, float scale)
+	{
+		auto it = std::find_if(weight_tables.begin(), weight_tables.end(), [&](auto const& t) {
+			return t.fft_size == fft_size && t.alpha == alpha && t.scale == scale; });
+		if (it == weight_tables.end()) {
+			// replace the least recently used.
+			if (weight_tables.size() < max_weight_tables) weight_tables.emplace_back();
+			it = weight_tables.end() - 1;
+			auto wt = std::make_shared_for_overwrite<float[]>(fft_size / 2);
+
+			// pre-calculate the bias of the colored noise, (0.5 + i)^{-alpha/2}.
+			float power = exp_scaled(wt.get(), log_bins(fft_size / 2), -alpha / 2, fft_size / 2);
+
+			// normalize the power.
+			power = scale / std::sqrt(power);
+			for (size_t i = 0; i < fft_size / 2; i++) wt[i] *= power;
+			*it = { fft_size, alpha, scale, std::move(wt) };
 		}
 
-		// normalize the power.
-		power = scale / std::sqrt(power);
-		for (size_t i = 0; i < fft_size / 2; i++) wt[i] *= power;
+		// move it to the front.
+		std::rotate(weight_tables.begin(), it, it + 1);
+		return weight_tables.front().wt;
 	}
 
-public:
-	static inline void* memory_ptr = nullptr;
-};
-struct gaussian_noise : colored_noise {
-	gaussian_noise(float alpha, uint32_t fft_size, uint32_t seed, uint_fast64_t pos, size_t alt = 0)
-		: alpha{ alpha }
-		, fft_size{ alpha == 0 ? 2 /* to let `get_index()` always return 0 */ : fft_size }
-		, buf{ alpha == 0 ? reinterpret_cast<float*>(memory_ptr) + alt :
-			(wt_tbl(fft_size) + (fft_size / 2)) + (1 + fft_size) * alt + 1 }
-		, pos{ pos }, rng{ seed }
-		, red_bits{ std::bit_width(max_fft_size) - std::bit_width(fft_size) }
+	// writes the values of `n` samples to `out` for each channel.
+	// the generator moves whenever `phase` stepped by `delta` carries,
+	// and the values are interpolated from `prev` by `phase` if `interpolate`.
+	// `prev` holds the values before the current ones, and is updated along with `phase`.
+	template<size_t channels, class noise_gen>
+	static void fill_samples(noise_gen& gen, float* const (&out)[channels], float (&prev)[channels],
+		size_t n, uint32_t& phase, uint64_t delta, bool interpolate)
 	{
-		if (alpha == 0) {
-			// white noise.
-			// adjust the position and cache the current value.
-			rng.discard(pos);
-			curr_value() = rng();
+		auto value = [&](size_t c) {
+			if constexpr (channels == 1) return gen.value();
+			else return gen.value(c);
+		};
+		if constexpr (requires { gen.block(); gen.advance(n); }) {
+			if (delta == phase_one) {
+				// every sample takes the next value, so read by blocks.
+				auto const t = interpolate ? phase_to_float(phase) : 0.0f;
+				for (size_t i = 0; i < n;) {
+					auto const m = std::min(gen.block().size(), n - i);
+					for (size_t c = 0; c < channels; c++) {
+						auto const src = gen.block(c).data();
+						for (size_t j = 0; j + 1 < m; j++)
+							out[c][i + j] = (1 - t) * src[j] + t * src[j + 1];
+						prev[c] = src[m - 1];
+					}
+					// the last one needs the value after the block.
+					gen.advance(m);
+					i += m;
+					for (size_t c = 0; c < channels; c++)
+						out[c][i - 1] = (1 - t) * prev[c] + t * value(c);
+				}
+				return;
+			}
 		}
-		else {
-			// colored noise other than white. prepare for FFT.
-			init_fft();
 
-			// pre-calculate the weight table.
-			if (alt == 0) prepare_weight_table(fft_size, alpha, 0.5f);
+		// find the samples that step in each chunk, and write the runs between them.
+		float curr[channels];
+		for (size_t c = 0; c < channels; c++) curr[c] = value(c);
+		uint16_t steps[fill_chunk + 1];
+		for (size_t i0 = 0; i0 < n; i0 += fill_chunk) {
+			auto const m = std::min(n - i0, fill_chunk);
+			size_t num_steps = 0;
+			uint64_t acc = phase;
+			for (size_t i = 0; i < m; i++) {
+				acc += delta;
+				steps[num_steps] = static_cast<uint16_t>(i);
+				num_steps += static_cast<size_t>(acc >> 32);
+				acc &= phase_one - 1;
+			}
+			steps[num_steps] = static_cast<uint16_t>(m);
+
+			for (size_t s = 0, i = 0; s <= num_steps; s++) {
+				auto const len = steps[s] - i;
+				auto const ph = static_cast<uint32_t>(phase + (i + 1) * delta);
+				for (size_t c = 0; c < channels; c++)
+					fill_run(out[c] + i0 + i, len, ph, static_cast<uint32_t>(delta), prev[c], curr[c], interpolate);
+				i += len;
+				if (s < num_steps) {
+					for (size_t c = 0; c < channels; c++) prev[c] = curr[c];
+					gen.move_next();
+					for (size_t c = 0; c < channels; c++) curr[c] = value(c);
+				}
+			}
+			phase = static_cast<uint32_t>(acc);
+		}
+	}
 
-			// expand values to buf; needs two passes.
-			std::memset(buf + (fft_size / 2), 0, (fft_size / 2) * sizeof(float));
-			rng.discard((2 * pos) & (0uLL - fft_size));
-			batch(); // pass 1.
-			batch(); // pass 2.
+	// number of samples whose steps are found at once.
+	constexpr static size_t fill_chunk = 256;
+	// the phase keeps 32 fractional bits in fixed point, so the steps are exact without drift.
+	constexpr static uint64_t phase_one = uint64_t{ 1 } << 32;
+	static float phase_to_float(uint32_t phase) {
+		return static_cast<float>(static_cast<int32_t>(phase >> 8)) * 0x1p-24f;
+	}
+	// writes a run of samples without steps, the first at the phase `ph`.
+	static void fill_run(float* dst, size_t len, uint32_t ph, uint32_t delta, float a, float b, bool interpolate)
+	{
+		if (!interpolate) {
+			std::fill_n(dst, len, a);
+			return;
 		}
+		size_t j = 0;
+#ifdef SIGMA_LIB_PHILOX_SSE2
+		auto p = _mm_setr_epi32(static_cast<int32_t>(ph), static_cast<int32_t>(ph + delta),
+			static_cast<int32_t>(ph + 2 * delta), static_cast<int32_t>(ph + 3 * delta));
+		auto const dp = _mm_set1_epi32(static_cast<int32_t>(4 * delta));
+		auto const va = _mm_set1_ps(a), vb = _mm_set1_ps(b);
+		for (; j + 4 <= len; j += 4, ph += 4 * delta, p = _mm_add_epi32(p, dp)) {
+			auto const t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(p, 8)), _mm_set1_ps(0x1p-24f));
+			_mm_storeu_ps(dst + j, _mm_add_ps(
+				_mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), t), va), _mm_mul_ps(t, vb)));
+		}
+#endif
+		for (; j < len; j++, ph += delta) {
+			auto const t = phase_to_float(ph);
+			dst[j] = (1 - t) * a + t * b;
+		}
+	}
+
+public:
+	// the space of the generators on this thread; the look-ahead thread has its own.
+	static inline thread_local void* memory_ptr = nullptr;
+
+	// the step of the phase per sample, in fixed point. `delta` is in [0, 1].
+	static uint64_t phase_delta(double delta) {
+		return std::min(static_cast<uint64_t>(std::llround(std::ldexp(delta, 32))), phase_one);
+	}
+	// number of moves of a generator over `n` samples from `phase`.
+	static uint64_t count_steps(size_t n, uint32_t phase, uint64_t delta) { return (phase + n * delta) >> 32; }
+
+	// sizes up to this fit in the shared memory of exedit.
+	constexpr static size_t max_shared_fft_size = FFT::max_size;
+	// space for the sizes larger than `max_shared_fft_size`, shared by the objects.
+	// each use takes a new `ticket`, by which the user tells the space is as it left by `heap_kept()`.
+	static void* heap_space(uint32_t fft_size, uint64_t* ticket = nullptr)
+	{
+		auto const len = space_size(fft_size);
+		if (heap.size() < len) heap.resize(len);
+		heap_ticket++;
+		if (ticket != nullptr) *ticket = heap_ticket;
+		return heap.data();
+	}
+	static bool heap_kept(uint64_t ticket) { return ticket == heap_ticket; }
+	// number of floats the generators use from `memory_ptr`.
+	constexpr static size_t space_size(uint32_t fft_size)
+	{
+		// the FFT buffer and the output buffers of two channels,
+		// or the layout of the convolution.
+		return std::max<size_t>(
+			2 * fft_size + 2 * (1 + fft_size) + 1,
+			2 * conv_block(fft_size) + 2 * (2 * conv_block(fft_size) + 2 * fft_size));
 	}
 
-	float value() const { return curr_value(); }
+private:
+	static inline std::vector<float> heap{};
+	static inline uint64_t heap_ticket = 0;
+
+	// the weight tables, the most recently used first.
+	struct weight_table_entry {
+		uint32_t fft_size;
+		float alpha, scale;
+		std::shared_ptr<float const[]> wt;
+	};
+	constexpr static size_t max_weight_tables = 8;
+	static inline std::vector<weight_table_entry> weight_tables{};
+	static inline std::vector<float> log_bin_tbl{};
+
+	// coefficients of exp(r) on [-\ln 2 / 2, \ln 2 / 2] (from Cephes).
+	constexpr static float
+		log2e = 1.44269504f,
+		ln2_hi = 0.693359375f, ln2_lo = -2.12194440e-4f;
+	constexpr static float exp_coef[] = {
+		1.9875691500e-4f, 1.3981999507e-3f, 8.3334519073e-3f,
+		4.1665795894e-2f, 1.6666665459e-1f, 5.0000001201e-1f,
+	};
+};
+// the caches independent of the engines, shared by the instances of `gaussian_noise`.
+struct gaussian_noise_base : colored_noise {
+protected:
+	// the caches below are replaced as a whole when the parameters change, and never modified in place,
+	// so the generators hold the ones of their parameters for as long as they run.
+
+	// spectra of the kernel partitions of the convolution, cached for the latest parameters.
+	static inline std::shared_ptr<FFT::cpx const[]> kernel{};
+	static inline float kernel_alpha = 0;
+	static inline uint32_t kernel_size = 0;
+
+	// H(z) = direct + sum of residue / (1 - pole z^-1) of the recursive filters, cached for the latest parameters.
+	// the number of poles is kept even, padded with zeros.
+	constexpr static size_t max_sections = 2 * (std::bit_width(noise::Exdata::max_fft_size) / 2 + 1) + 2;
+	struct sections_coef {
+		std::vector<double> pole, residue;
+		double direct;
+		uint_fast64_t warmup; // number of samples to run ahead on seeking.
+	};
+	static inline std::shared_ptr<sections_coef const> sections{};
+	static inline float sections_alpha = 0;
+	static inline uint32_t sections_size = 0;
+};
+template<class engine>
+struct gaussian_noise : gaussian_noise_base {
+	using method_t = decltype(noise::Exdata::method);
+	using sampler_t = decltype(noise::Exdata::sampler);
+	// the mutable part of the generator, to resume it on the same space in a later frame.
+	struct resume_state {
+		uint_fast64_t pos;
+		normal_rng<float, engine> rng, rng_r;
+		double states[2][max_sections];
+	};
+	// resumes from `from` instead of `pos` if given, whose buffers must be left on the space.
+	gaussian_noise(float alpha, uint32_t fft_size, method_t method, sampler_t sampler, uint32_t seed, uint_fast64_t pos,
+		size_t alt = 0, resume_state const* from = nullptr)
+		: gaussian_noise{ alpha, fft_size, method, sampler, seed, seed, pos, alt, false, from } {}
+	// stereo generator, whose two channels share a single FFT.
+	constexpr static struct stereo_t {} stereo_tag{};
+	gaussian_noise(stereo_t, float alpha, uint32_t fft_size, method_t method, sampler_t sampler,
+		uint32_t seed_l, uint32_t seed_r, uint_fast64_t pos, resume_state const* from = nullptr)
+		: gaussian_noise{ alpha, fft_size, method, sampler, seed_l, seed_r, pos, 0, true, from } {}
+	resume_state save() const {
+		resume_state ret{ pos, rng, rng_r, {} };
+		std::memcpy(ret.states, states, sizeof(states));
+		return ret;
+	}
+
+	float value(size_t ch = 0) const { return curr_value(ch); }
 	void move_next() {
 		pos++;
 		move_next_core();
 	}
+	// the values from the current position to the end of the current batch.
+	std::span<float const> block(size_t ch = 0) const { return { &curr_value(ch), hop - get_index(pos) }; }
+	// moves by `n` values, up to the size of `block()`.
+	void advance(size_t n) {
+		if (n == 0) return;
+		pos += n;
+		move_next_core();
+	}
+	// writes the values of `n` samples; two channels for the stereo generator.
+	// see `colored_noise::fill_samples()`.
+	template<size_t channels>
+	void fill(float* const (&out)[channels], float (&prev)[channels],
+		size_t n, uint32_t& phase, uint64_t delta, bool interpolate) {
+		fill_samples(*this, out, prev, n, phase, delta, interpolate);
+	}
 
 	float const alpha;
 	uint32_t const fft_size;
+	method_t const method;
+	uint32_t const hop; // number of values produced by each batch.
 	uint_fast64_t pos;
-	normal_rng<float> rng;
+	normal_rng<float, engine> rng, rng_r;
+	bool const stereo;
 	float* const buf;
+	std::shared_ptr<float const[]> const wt; // weight table for the FFT method.
+
+	// number of floats the generators of the parameters use from `memory_ptr`, up to `space_size()`.
+	constexpr static size_t space_used(float alpha, uint32_t fft_size, method_t method)
+	{
+		// two channels of a block.
+		if (alpha == 0) return 2 * white_block;
+		if (method == noise::Exdata::method_sections) return 2 * sections_block;
+		return space_size(fft_size);
+	}
+	// the part of the space carried over to the next batches; the rest is scratch.
+	std::span<float const> live_space() const
+	{
+		return { buf, (stereo ? channel_offset() : 0) +
+			(alpha == 0 || method == noise::Exdata::method_sections ? hop :
+			method == noise::Exdata::method_convolution ? channel_offset() : fft_size) };
+	}
 
 private:
-	int const red_bits; // number of bits reduced from the maximum.
+	gaussian_noise(float alpha, uint32_t fft_size, method_t method, sampler_t sampler,
+		uint32_t seed_l, uint32_t seed_r, uint_fast64_t pos, size_t alt, bool stereo, resume_state const* from)
+		: alpha{ alpha }
+		, fft_size{ fft_size }
+		, method{ alpha == 0 ? noise::Exdata::method_fft : method }
+		, hop{ alpha == 0 ? white_block :
+			this->method == noise::Exdata::method_convolution ? conv_block(fft_size) :
+			this->method == noise::Exdata::method_sections ? sections_block : this->fft_size / 2 }
+		, pos{ from != nullptr ? from->pos : pos }
+		, rng{ from != nullptr ? from->rng : normal_rng<float, engine>{ seed_l, sampler == noise::Exdata::sampler_ziggurat } }
+		, rng_r{ from != nullptr ? from->rng_r : normal_rng<float, engine>{ seed_r, sampler == noise::Exdata::sampler_ziggurat } }
+		, stereo{ stereo }
+		, buf{ alpha == 0 ? reinterpret_cast<float*>(memory_ptr) + hop * alt :
+			this->method == noise::Exdata::method_convolution ?
+			reinterpret_cast<float*>(memory_ptr) + 2 * hop + (2 * hop + 2 * fft_size) * alt :
+			this->method == noise::Exdata::method_sections ?
+			reinterpret_cast<float*>(memory_ptr) + hop * alt :
+			out_buf(fft_size) + (1 + fft_size) * alt + 1 }
+		, wt{ alpha == 0 || this->method != noise::Exdata::method_fft ? nullptr :
+			weight_table(fft_size, alpha, 0.5f) }
+	{
+		// the shared caches, which other generators may have replaced since the last use.
+		if (this->method == noise::Exdata::method_convolution) {
+			if (alt == 0) prepare_kernel();
+			kern = kernel;
+		}
+		if (this->method == noise::Exdata::method_sections) {
+			if (alt == 0) prepare_sections();
+			coef = sections;
+			coef_pole = coef->pole.data(); coef_residue = coef->residue.data();
+			coef_direct = coef->direct; num_poles = coef->pole.size();
+		}
+
+		if (from != nullptr) {
+			// the buffers are left as they were.
+			std::memcpy(states, from->states, sizeof(states));
+		}
+		else if (alpha == 0) {
+			// white noise.
+			// adjust the position and fill the current block.
+			rng.discard(pos & (0uLL - hop));
+			if (stereo) rng_r.discard(pos & (0uLL - hop));
+			batch();
+		}
+		else if (this->method == noise::Exdata::method_convolution) {
+			// colored noise by convolution.
+			init_conv(0);
+			if (stereo) init_conv(1);
+		}
+		else if (this->method == noise::Exdata::method_sections) {
+			// colored noise by recursive filters.
+			init_sections(0);
+			if (stereo) init_sections(1);
+		}
+		else {
+			// colored noise other than white.
+			// expand values to buf; needs two passes.
+			std::memset(buf + (fft_size / 2), 0, (fft_size / 2) * sizeof(float));
+			rng.discard((2 * pos) & (0uLL - fft_size));
+			if (stereo) {
+				std::memset(buf + channel_offset() + (fft_size / 2), 0, (fft_size / 2) * sizeof(float));
+				rng_r.discard((2 * pos) & (0uLL - fft_size));
+			}
+			batch(); // pass 1.
+			batch(); // pass 2.
+		}
+	}
 
 	// call this *after* incrementing pos.
 	void move_next_core() {
-		if (alpha == 0) curr_value() = rng();
-		else if (get_index(pos) == 0) batch();
+		if (get_index(pos) == 0) batch();
 	}
-	float& curr_value() const { return buf[get_index(pos)]; }
-	size_t get_index(uint_fast64_t p) const { return p & ((fft_size / 2) - 1); }
+	// the right channel is placed where a mono generator with `alt = 1` would be.
+	size_t channel_offset() const {
+		return alpha == 0 ? hop :
+			method == noise::Exdata::method_convolution ? 2 * hop + 2 * fft_size :
+			method == noise::Exdata::method_sections ? hop : 1 + fft_size;
+	}
+	float& curr_value(size_t ch) const { return buf[ch * channel_offset() + get_index(pos)]; }
+	size_t get_index(uint_fast64_t p) const { return p & (hop - 1); }
 
 	void batch()
 	{
-		// assumes alpha is nonzero.
+		if (alpha == 0) return batch_white();
+		if (method == noise::Exdata::method_convolution) return batch_conv();
+		if (method == noise::Exdata::method_sections) return batch_sections();
+		if (stereo) return batch_stereo();
+
 		// set random values to the frequency space.
-		auto const* const wt = wt_tbl(fft_size);
-		auto const buf1 = fft_buf(), buf2 = buf1 + fft_size;
+		auto const& pl = plan(fft_size);
+		auto const buf1 = fft_buf();
+		auto const* const w = wt.get();
+		rng.fill({ reinterpret_cast<float*>(buf1), fft_size });
+		for (size_t i = 0; i < fft_size / 2; i++)
+			// the conjugate half is implied by the real transform.
+			buf1[i] *= w[i];
+
+		// perform inverse FFT, whose image is real and shifted in frequency by 0.5.
+		auto const ptr = reinterpret_cast<float const*>(pl.inv_real(buf1, columns));
+
+		// place the values to the destination buffer.
 		for (size_t i = 0; i < fft_size / 2; i++) {
-			buf1[i] = { wt[i] * rng(), wt[i] * rng() };
-			buf1[fft_size - 1 - i] = std::conj(buf1[i]); // equivalent to discarding .imag() of the output.
+			auto const j = i + fft_size / 2;
+			// glue with the half of the previous section, using the square root of Hann function.
+			auto const q = pl.q(i);
+			buf[i] = q.imag() * ptr[i] + buf[j];
+			buf[j] = q.real() * ptr[j];
 		}
+	}
 
-		// perform inverse FFT.
-		auto const ptr = fft->inv(buf1, buf2, fft_size);
+	// white noise is drawn by blocks of this length.
+	constexpr static uint32_t white_block = 256;
+	void batch_white()
+	{
+		rng.fill({ buf, hop });
+		if (stereo) rng_r.fill({ buf + channel_offset(), hop });
+	}
 
-		// place the values to the destination buffer.
+	// number of bins drawn at once in the stereo generator.
+	constexpr static size_t stereo_chunk = 64;
+	static_assert(noise::Exdata::min_fft_size / 2 % stereo_chunk == 0);
+	void batch_stereo()
+	{
+		// assumes alpha is nonzero.
+		// set random values to the frequency space;
+		// the left channel to the real part, and the right to the imaginary part.
+		auto const& pl = plan(fft_size);
+		auto const buf1 = fft_buf();
+		auto const* const w = wt.get();
+		for (size_t i0 = 0; i0 < fft_size / 2; i0 += stereo_chunk) {
+			// the random values of both channels for a chunk of bins.
+			FFT::cpx vals_l[stereo_chunk], vals_r[stereo_chunk];
+			rng.fill({ reinterpret_cast<float*>(vals_l), 2 * stereo_chunk });
+			rng_r.fill({ reinterpret_cast<float*>(vals_r), 2 * stereo_chunk });
+			for (size_t k = 0; k < stereo_chunk; k++) {
+				auto const i = i0 + k;
+				FFT::cpx const l = w[i] * vals_l[k], r = w[i] * vals_r[k];
+				buf1[i] = { l.real() - r.imag(), l.imag() + r.real() }; // l + i r.
+				buf1[fft_size - 1 - i] = { l.real() + r.imag(), r.real() - l.imag() }; // conj(l) + i conj(r).
+			}
+		}
+
+		// perform inverse FFT, whose image is L + i R after the tilt below.
+		auto const ptr = pl.inv(buf1, columns);
+
+		// place the values to the destination buffers.
+		auto const buf_r = buf + channel_offset();
 		for (size_t i = 0; i < fft_size / 2; i++) {
 			auto const j = i + fft_size / 2;
 			// - tilt by `pi i n/N` so the frequency is shifted by 0.5.
-			// - only the real part is in interest.
 			// - glue with the half of the previous section, using the square root of Hann function.
-			auto const& q = fft->q(i << red_bits);
-			buf[i] = q.imag() * (
-				// \Re(q p_i)
-				q.real() * ptr[i].real() - q.imag() * ptr[i].imag())
-				+ buf[j];
-			buf[j] = q.real() * (
-				// \Re(\sqrt{-1}q p_j)
-				-q.imag() * ptr[j].real() - q.real() * ptr[j].imag());
+			auto const q = pl.q(i);
+			auto const zi = q * ptr[i], zj = q * ptr[j];
+			buf[i] = q.imag() * zi.real() + buf[j];
+			buf_r[i] = q.imag() * zi.imag() + buf_r[j];
+			// multiplied by \sqrt{-1} for the latter half.
+			buf[j] = -q.real() * zj.imag();
+			buf_r[j] = q.real() * zj.real();
+		}
+	}
+
+	////////////////////////////////
+	// uniformly-partitioned convolution.
+	// white noise w_n is filtered by the kernel h of length `fft_size`,
+	// which is split into `fft_size/hop` partitions of length `hop`.
+	// each block of `hop` values costs the same regardless of `fft_size`.
+	// the transforms are shifted by half a bin, so the convolutions are anti-cyclic,
+	// which doesn't matter to overlap-save.
+	////////////////////////////////
+
+	// layout of each channel: the output, the last input block, and the spectra of the past inputs.
+	float* prev_input(size_t ch) const { return buf + ch * channel_offset() + hop; }
+	FFT::cpx* past_spectra(size_t ch) const {
+		return reinterpret_cast<FFT::cpx*>(buf + ch * channel_offset() + 2 * hop);
+	}
+	// work space of `hop` complex numbers, shared by the channels.
+	static FFT::cpx* conv_work() { return fft_buf(); }
+	size_t partitions() const { return fft_size / hop; }
+	std::shared_ptr<FFT::cpx const[]> kern{}; // `kernel` of the parameters.
+
+	void prepare_kernel()
+	{
+		if (kernel_alpha == alpha && kernel_size == fft_size) return;
+
+		// zero-phase kernel from the weights, which is anti-periodic of length `fft_size`.
+		// transformed apart from the space, which may hold the inputs of a resumed generator.
+		auto const& pl = plan(fft_size);
+		auto const wt1 = weight_table(fft_size, alpha, 1.0f);
+		std::vector<FFT::cpx> work(fft_size / 2);
+		auto const X = work.data();
+		for (size_t i = 0; i < fft_size / 2; i++) X[i] = wt1[i];
+		auto const h = reinterpret_cast<float*>(pl.inv_real(X, columns));
+
+		// make it causal by rotating half the length, and taper by Hann window.
+		float power = 0;
+		for (size_t i = 0; i < fft_size / 2; i++) {
+			auto const j = i + fft_size / 2;
+			auto const wi = pl.q(i).imag(), wj = pl.q(j).imag();
+			auto const hi = -h[j] * (wi * wi), hj = h[i] * (wj * wj);
+			h[i] = hi; h[j] = hj;
+			power += hi * hi + hj * hj;
+		}
+		// normalize so the output has the unit variance,
+		// including the factor of the inverse transform of length `2 hop`.
+		power = 1 / (std::sqrt(power) * (2 * hop));
+
+		// spectra of the partitions, each zero-padded to the length `2 hop`.
+		auto const& pl_block = plan(2 * hop);
+		auto const spectra = std::make_shared_for_overwrite<FFT::cpx[]>(fft_size);
+		for (size_t p = 0; p < partitions(); p++) {
+			auto const H = spectra.get() + p * hop;
+			auto const Hf = reinterpret_cast<float*>(H);
+			for (size_t i = 0; i < hop; i++) {
+				Hf[i] = power * h[p * hop + i];
+				Hf[i + hop] = 0;
+			}
+			pl_block.fwd_real(H, columns);
+		}
+		kernel = spectra;
+		kernel_alpha = alpha;
+		kernel_size = fft_size;
+	}
+
+	void init_conv(size_t ch)
+	{
+		auto& r = ch == 0 ? rng : rng_r;
+		int64_t const
+			last = static_cast<int64_t>(pos / hop),
+			first = last - static_cast<int64_t>(partitions()) + 1;
+
+		// the input block preceding the first one; zero before the beginning.
+		auto const prev = prev_input(ch);
+		if (first > 0) {
+			r.discard(static_cast<uint_fast64_t>(first - 1) * hop);
+			for (size_t i = 0; i < hop; i++) prev[i] = r();
+		}
+		else std::memset(prev, 0, hop * sizeof(float));
+
+		// fill the spectra of the past inputs, then the current output.
+		for (auto j = first; j <= last; j++) push_block(ch, j);
+		emit_block(ch, last);
+	}
+
+	void batch_conv()
+	{
+		auto const j = static_cast<int64_t>(pos / hop);
+		push_block(0, j); emit_block(0, j);
+		if (stereo) { push_block(1, j); emit_block(1, j); }
+	}
+
+	// transforms the input block `j` together with the preceding one.
+	void push_block(size_t ch, int64_t j)
+	{
+		auto& r = ch == 0 ? rng : rng_r;
+		auto const prev = prev_input(ch);
+		auto const work = conv_work();
+		auto const wf = reinterpret_cast<float*>(work);
+		for (size_t i = 0; i < hop; i++) {
+			wf[i] = prev[i];
+			wf[i + hop] = prev[i] = j >= 0 ? r() : 0.0f;
+		}
+		plan(2 * hop).fwd_real(work, columns);
+
+		auto const X = past_spectra(ch) + slot(j) * hop;
+		std::memcpy(X, work, hop * sizeof(FFT::cpx));
+	}
+
+	// accumulates the products of the spectra, and writes the output block `j`.
+	void emit_block(size_t ch, int64_t j)
+	{
+		auto const work = conv_work();
+		std::fill_n(work, hop, FFT::cpx{});
+		for (size_t p = 0; p < partitions(); p++) {
+			auto const* const H = kern.get() + p * hop;
+			auto const* const X = past_spectra(ch) + slot(j - static_cast<int64_t>(p)) * hop;
+			for (size_t k = 0; k < hop; k++) work[k] += H[k] * X[k];
+		}
+
+		// the latter half of the image is free from the wrap-around.
+		auto const y = reinterpret_cast<float const*>(plan(2 * hop).inv_real(work, columns)) + hop;
+		std::memcpy(buf + ch * channel_offset(), y, hop * sizeof(float));
+	}
+	size_t slot(int64_t j) const {
+		auto const P = static_cast<int64_t>(partitions());
+		return static_cast<size_t>(((j % P) + P) % P);
+	}
+
+	////////////////////////////////
+	// bank of first-order recursive filters.
+	// poles and zeros are placed alternately in steps of two octaves, so that the response tilts
+	// by a constant slope above the lowest frequency of the FFT method.
+	// the slope is split into two staggered series for |alpha| > 2.
+	// the response is expanded into partial fractions, so the poles run independently.
+	// the filters have infinite memory, so they run ahead for a while on seeking.
+	////////////////////////////////
+
+	// the coefficients cached in `gaussian_noise_base` for the parameters, and the parts of them in use.
+	constexpr static uint32_t sections_block = 256;
+	double states[2][max_sections];
+	std::shared_ptr<sections_coef const> coef{};
+	double const* coef_pole = nullptr, * coef_residue = nullptr;
+	double coef_direct = 0;
+	size_t num_poles = 0;
+
+	void prepare_sections()
+	{
+		if (sections_alpha == alpha && sections_size == fft_size) return;
+		constexpr double pi = std::numbers::pi;
+		std::vector<double> zeros{}, poles{};
+		auto add = [&](double f_zero, double f_pole) {
+			zeros.push_back(std::exp(-2 * pi * f_zero));
+			poles.push_back(std::exp(-2 * pi * f_pole));
+		};
+
+		// each series tilts by `a` in the exponent of the power, which is within [-2, +2].
+		size_t const series = std::abs(alpha) > 2 ? 2 : 1;
+		double const a = static_cast<double>(alpha) / series, f_low = 0.5 / fft_size;
+		for (size_t i = 0; i < series; i++) {
+			for (double f = f_low * std::exp2(2.0 * i / series); f < 1; f *= 4)
+				// the zero is placed `a` octaves above the pole, or the other way round.
+				add(f * std::exp2(std::max(a, 0.0)), f * std::exp2(std::max(-a, 0.0)));
+		}
+
+		// (1 + b z^-1)/(1 + c z^-1) approximating (sin(pi f)/(pi f))^alpha,
+		// where digital poles deviate from analog ones; matched at 1/4 and 1/2 of the sampling rate.
+		double const
+			r = std::pow(2 / pi, alpha), t = std::pow(2 * std::numbers::sqrt2 / pi, alpha),
+			v = std::sqrt((t - 1) / (r - t)), u = std::sqrt(r) * v;
+		zeros.push_back(-(1 - u) / (1 + u));
+		poles.push_back(-(1 - v) / (1 + v));
+
+		// match the level to the FFT method, whose one-sided power density is
+		// fft_size (f fft_size)^-alpha / sum_k (k + 1/2)^-alpha, on average over the log-frequency.
+		auto response = [&](double f) {
+			auto const w = std::polar(1.0, -2 * pi * f);
+			double ret = 2;
+			for (size_t i = 0; i < poles.size(); i++)
+				ret *= std::norm((1.0 - zeros[i] * w) / (1.0 - poles[i] * w));
+			return ret;
+		};
+		double sum = 0;
+		for (size_t k = 0; k < fft_size / 2; k++) sum += std::pow(k + 0.5, -alpha);
+		constexpr size_t div = 8; // points per octave.
+		double log_ratio = 0; size_t cnt = 0;
+		for (double f = 2.0 / fft_size; f < 0.25; f *= std::exp2(1.0 / div), cnt++)
+			log_ratio += std::log(fft_size * std::pow(f * fft_size, -alpha) / (sum * response(f)));
+		double const gain = std::exp(log_ratio / (2 * cnt));
+
+		// partial fraction expansion.
+		size_t const len = (poles.size() + 1) & ~size_t{ 1 };
+		auto c = std::make_shared<sections_coef>(std::vector<double>(len), std::vector<double>(len), gain, 0);
+		for (size_t i = 0; i < poles.size(); i++) {
+			double residue = gain;
+			for (size_t j = 0; j < poles.size(); j++) {
+				residue *= 1 - zeros[j] / poles[i];
+				if (j != i) residue /= 1 - poles[j] / poles[i];
+			}
+			c->pole[i] = poles[i];
+			c->residue[i] = residue;
+			c->direct *= zeros[i] / poles[i];
+		}
+
+		// the transient of the slowest pole fades out to `warmup_tolerance` in this many samples.
+		double const slowest = std::ranges::max(poles, {}, [](double p) { return std::abs(p); });
+		c->warmup = static_cast<uint_fast64_t>(std::min(std::ceil(
+			std::log(warmup_tolerance) / std::log(std::abs(slowest))), static_cast<double>(max_warmup)));
+		sections = std::move(c);
+
+		sections_alpha = alpha;
+		sections_size = fft_size;
+	}
+
+	// the run ahead is capped regardless of `fft_size`, to bound the cost of seeking;
+	// the slowest poles of large sizes leave a residue in the lowest frequencies then.
+	constexpr static double warmup_tolerance = 1e-3;
+	constexpr static uint_fast64_t max_warmup = 1u << 16;
+
+	void init_sections(size_t ch)
+	{
+		auto& r = ch == 0 ? rng : rng_r;
+		auto const state = states[ch];
+		std::fill_n(state, num_poles, 0.0);
+
+		// let the transient fade out before the current block.
+		uint_fast64_t const curr = pos & (0uLL - hop),
+			start = curr > coef->warmup ? curr - coef->warmup : 0;
+		r.discard(start);
+		for (auto i = start; i < curr; i++) filter_sections(state, r());
+		fill_sections(ch);
+	}
+
+	void batch_sections()
+	{
+		fill_sections(0);
+		if (stereo) fill_sections(1);
+	}
+
+	void fill_sections(size_t ch)
+	{
+		auto& r = ch == 0 ? rng : rng_r;
+		auto const state = states[ch];
+		auto const out = buf + ch * channel_offset();
+		for (size_t i = 0; i < hop; i++)
+			out[i] = static_cast<float>(filter_sections(state, r()));
+	}
+
+	double filter_sections(double* state, double x) const
+	{
+		// two partial sums to pair the independent poles.
+		double y0 = coef_direct * x, y1 = 0;
+		for (size_t i = 0; i < num_poles; i += 2) {
+			double const s0 = coef_pole[i] * state[i] + x, s1 = coef_pole[i + 1] * state[i + 1] + x;
+			y0 += coef_residue[i] * s0;
+			y1 += coef_residue[i + 1] * s1;
+			state[i] = s0; state[i + 1] = s1;
 		}
+		return y0 + y1;
 	}
 };
 
-struct velvet_noise : colored_noise {
+// the caches independent of the engines, shared by the instances of `velvet_noise`.
+struct velvet_noise_base : colored_noise {
+	// moves the counters of the periods by `steps` positions as `move_next()` does,
+	// and returns `phase_period()` there.
+	static double step_period(double period, uint_fast64_t steps, uint_fast64_t& count_period, uint32_t& pos_period_16)
+	{
+		auto const period_16 = fixed_period(period);
+		auto const p = pos_period_16 + steps * denom_period;
+		count_period += p / period_16;
+		pos_period_16 = static_cast<uint32_t>(p % period_16);
+		return pos_period_16 / static_cast<double>(period_16);
+	}
+
+protected:
+	// response of a section to a pulse at its head, cached for the latest parameters.
+	// replaced as a whole when the parameters change, so the generators hold the one of their parameters.
+	static inline std::shared_ptr<float const[]> pulse_kernel{};
+	static inline float pulse_kernel_alpha = 0;
+	static inline uint32_t pulse_kernel_size = 0;
+
+	// the periods are in fixed point with the denominator `denom_period`.
+	constexpr static int32_t denom_period_bits = 16, denom_period = 1 << denom_period_bits;
+	static uint32_t fixed_period(double period) { return static_cast<uint32_t>(std::lround(denom_period * period)); }
+};
+template<class engine>
+struct velvet_noise : velvet_noise_base {
+	// the mutable part of the generator, to resume it on the same space in a later frame.
+	struct resume_state {
+		uint_fast64_t pos, count_period;
+		uint32_t pos_period_16, pos_pulse;
+		float val_pulse;
+		engine rng;
+	};
+	// resumes from `from` instead of the positions if given, whose buffer must be left on the space.
 	velvet_noise(double period, float alpha, uint32_t fft_size, uint32_t seed,
-		uint_fast64_t pos, uint_fast64_t count_period, double phase_period, size_t alt = 0)
-		: period_16{ static_cast<uint32_t>(std::lround(denom_period * period)) }, fft_size{ fft_size }, alpha{ alpha }
-		, pos{ pos }, rng{ seed ^ philox::default_seed }
+		uint_fast64_t pos, uint_fast64_t count_period, double phase_period,
+		size_t alt = 0, resume_state const* from = nullptr)
+		: alpha{ alpha }, fft_size{ fft_size }, pos{ pos }
+		, period_16{ fixed_period(period) }, rng{ from != nullptr ? from->rng : engine{ seed ^ engine::default_seed } }
 		, buf{ alpha == 0 ? nullptr :
-			(wt_tbl(fft_size) + (fft_size / 2)) + fft_size * alt }
-		, red_bits{ std::bit_width(max_fft_size) - std::bit_width(fft_size) }
+			out_buf(fft_size) + fft_size * alt }
+		, wt{ alpha == 0 ? nullptr : weights(fft_size, alpha) }
+		, sparse{ alpha != 0 && prefers_sparse(fft_size, period_16) }
 	{
+		// the shared cache, which other generators may have replaced since the last use.
+		if (alt == 0 && sparse) prepare_pulse_kernel();
+		if (sparse) pk = pulse_kernel;
+
+		if (from != nullptr) {
+			this->pos = from->pos; this->count_period = from->count_period;
+			pos_period_16 = from->pos_period_16; pos_pulse = from->pos_pulse; val_pulse = from->val_pulse;
+			return;
+		}
+
 		this->count_period = count_period +
 			floor_div(std::lround(denom_period * phase_period * period), period_16, pos_period_16);
 
 		if (alpha == 0) {
-			rng.discard(max_fft_size + count_period);
+			rng.discard(rng_offset(0) + count_period);
 			set_next();
 		}
 		else {
-			// colored noise other than white. prepare for FFT.
-			init_fft();
-
-			// pre-calculate the weight table.
-			if (alt == 0) prepare_weight_table(fft_size, alpha,
-				1 / std::sqrtf(static_cast<float>(2 * fft_size)));
-
+			// colored noise other than white.
 			// prepare output buffer. adjust positions.
 			int32_t pos_period_0;
-			auto const rng_pos = max_fft_size + count_period + static_cast<uint_fast64_t>(
-				floor_div(static_cast<int32_t>(
-					pos_period_16 - (((static_cast<uint32_t>(pos) & (fft_size / 2 - 1)) + (fft_size / 2)) << denom_period_bits)),
+			auto const rng_pos = rng_offset(fft_size) + count_period + static_cast<uint_fast64_t>(
+				floor_div(static_cast<int64_t>(pos_period_16) -
+					(static_cast<int64_t>((pos & (fft_size / 2 - 1)) + (fft_size / 2)) << denom_period_bits),
 					period_16, pos_period_0));
 
 			// expand values to buf; needs two passes.
 			rng.discard(rng_pos);
 			batch(pos_period_0);
-			batch((pos_period_0 + ((fft_size / 2) << denom_period_bits)) % period_16);
+			batch(static_cast<uint32_t>((pos_period_0 + (uint_fast64_t{ fft_size / 2 } << denom_period_bits)) % period_16));
 		}
 	}
 
@@ -766,41 +1861,143 @@ struct velvet_noise : colored_noise {
 			if (get_index(pos) == 0) batch(pos_period_16);
 		}
 	}
+	// writes the values of `n` samples. see `colored_noise::fill_samples()`.
+	void fill(float* const (&out)[1], float (&prev)[1],
+		size_t n, uint32_t& phase, uint64_t delta, bool interpolate) {
+		if (alpha == 0 && delta == phase_one) return fill_white(out[0], prev[0], n, phase, interpolate);
+		fill_samples(*this, out, prev, n, phase, delta, interpolate);
+	}
 	double period() const { return period_16 / static_cast<double>(denom_period); }
 	double phase_period() const { return pos_period_16 / static_cast<double>(period_16); }
+	resume_state save() const { return { pos, count_period, pos_period_16, pos_pulse, val_pulse, rng }; }
 
-private:
-	constexpr static int32_t denom_period_bits = 16, denom_period = 1 << denom_period_bits;
+	// number of floats the generators of the parameters use from `memory_ptr`, up to `space_size()`.
+	constexpr static size_t space_used(float alpha, uint32_t fft_size) { return alpha == 0 ? 0 : space_size(fft_size); }
+	// the part of the space carried over to the next batches; the rest is scratch.
+	std::span<float const> live_space() const { return { buf, alpha == 0 ? 0 : fft_size }; }
 
-	int const red_bits; // number of bits reduced from the maximum.
+private:
+	// the random sequence is offset so the positions before the first batch stay non-negative.
+	// kept at 8192 for the sizes that existed before, so the noise doesn't change.
+	constexpr static uint_fast64_t rng_offset(uint32_t fft_size) { return std::max(fft_size, 1u << 13); }
 
-	using philox = sigma_lib::rng::philox_test::philox4x32;
 	uint32_t const period_16; uint32_t pos_period_16; // denominator 2^16.
-	philox rng;
-	uint32_t pos_pulse;
-	float val_pulse;
+	engine rng;
+	uint32_t pos_pulse = 0;
+	float val_pulse = 0;
 	float* const buf;
+	std::shared_ptr<float const[]> const wt;
+	bool const sparse; // synthesize by adding the kernel at each pulse, instead of FFT.
+	std::shared_ptr<float const[]> pk{}; // `pulse_kernel` of the parameters.
+
+	static std::shared_ptr<float const[]> weights(uint32_t fft_size, float alpha) {
+		return weight_table(fft_size, alpha, 1 / std::sqrtf(static_cast<float>(2 * fft_size)));
+	}
 
 	size_t get_index(uint_fast64_t p) const { return p & ((fft_size / 2) - 1); }
 
+	// the sparse synthesis costs about `fft_size` per pulse, and the two transforms about `fft_size` times its log.
+	// the ratio is on the safe side of the measured break-even, which grows a little faster than the log.
+	constexpr static uint32_t sparse_cost_ratio = 4;
+	static bool prefers_sparse(uint32_t fft_size, uint32_t period_16) {
+		return (uint_fast64_t{ fft_size } << denom_period_bits) <
+			uint_fast64_t{ sparse_cost_ratio } * std::bit_width(fft_size) * period_16;
+	}
+	// the response to a unit pulse at the head of a section, through the same transforms as `batch()`.
+	// the filter is a negacyclic convolution, because of the frequencies shifted by 0.5.
+	void prepare_pulse_kernel()
+	{
+		if (pulse_kernel_alpha == alpha && pulse_kernel_size == fft_size) return;
+		auto const h = std::make_shared_for_overwrite<float[]>(fft_size);
+
+		auto const& pl = plan(fft_size);
+		auto const buf1 = fft_buf();
+		std::fill_n(buf1, fft_size, FFT::cpx{});
+		buf1[0] = pl.q(0);
+		auto ptr = pl.inv(buf1, columns);
+		for (size_t i = 0; i < fft_size / 2; i++) {
+			auto const v = wt[i] * ptr[i];
+			buf1[i] = std::conj(v);
+			buf1[fft_size - 1 - i] = v;
+		}
+		ptr = pl.inv(buf1, columns);
+		for (size_t i = 0; i < fft_size / 2; i++) {
+			auto const j = i + fft_size / 2;
+			auto const q = pl.q(i);
+			h[i] = q.real() * ptr[i].real() - q.imag() * ptr[i].imag();
+			h[j] = -q.imag() * ptr[j].real() - q.real() * ptr[j].imag();
+		}
+		pulse_kernel = h;
+		pulse_kernel_alpha = alpha; pulse_kernel_size = fft_size;
+	}
+
 	void set_next() { std::tie(pos_pulse, val_pulse) = parse_rand(rng(), period_16, pos_period_16); }
+
+	// white noise where every sample takes the next value; renders the pulses only.
+	void fill_white(float* out, float& prev, size_t n, uint32_t phase, bool interpolate)
+	{
+		if (n == 0) return;
+		render_white(out, n);
+		prev = out[n - 1];
+		auto const t = interpolate ? phase_to_float(phase) : 0.0f;
+		if (t == 0) return;
+		for (size_t i = 0; i + 1 < n; i++) out[i] = (1 - t) * out[i] + t * out[i + 1];
+		out[n - 1] = (1 - t) * out[n - 1] + t * value();
+	}
+	// writes the values of `n` samples from the current position, and moves by `n`.
+	// skips from a period to the next, drawing the words for the pulses at once.
+	void render_white(float* dst, size_t n)
+	{
+		std::fill_n(dst, n, 0.0f);
+		size_t k = 0;
+		auto place = [&] {
+			// the pulse of the current period, unless passed or beyond the end.
+			auto const curr = pos_period_16 >> denom_period_bits;
+			if (pos_pulse >= curr && k + (pos_pulse - curr) < n)
+				dst[k + (pos_pulse - curr)] = val_pulse;
+		};
+
+		// number of the periods that end within the samples.
+		auto wraps = (pos_period_16 + uint_fast64_t{ n } * denom_period) / period_16;
+		typename engine::result_type words[64];
+		while (wraps > 0) {
+			auto const w = static_cast<size_t>(std::min<uint_fast64_t>(wraps, std::size(words)));
+			rng.generate(std::span{ words, w });
+			wraps -= w;
+			for (size_t j = 0; j < w; j++) {
+				place();
+				auto const len = (period_16 - pos_period_16 + (denom_period - 1)) >> denom_period_bits;
+				k += len;
+				pos_period_16 += len * denom_period - period_16;
+				count_period++;
+				std::tie(pos_pulse, val_pulse) = parse_rand(words[j], period_16, pos_period_16);
+			}
+		}
+		place();
+		pos_period_16 += static_cast<uint32_t>(n - k) * denom_period;
+		pos += n;
+	}
 	void batch(uint32_t pos_period_0)
 	{
 		// assumes alpha is nonzero.
 		auto rng1 = rng;
 
 		// estimate the next batch state.
-		rng.discard(floor_div(pos_period_0 + ((fft_size / 2) << denom_period_bits), period_16));
+		rng.discard(floor_div(pos_period_0 + (uint_fast64_t{ fft_size / 2 } << denom_period_bits), period_16));
+
+		if (sparse) return batch_sparse(rng1, pos_period_0);
 
 		// set velvet noise to the time space.
-		auto const buf1 = fft_buf(), buf2 = buf1 + fft_size;
-		std::memset(buf1, 0, sizeof(FFT::cpx) * fft_size);
+		auto const& pl = plan(fft_size);
+		auto const buf1 = fft_buf();
+		auto const* const w = wt.get();
+		std::fill_n(buf1, fft_size, FFT::cpx{});
 		auto [pos_pulse_1, val_pulse_1] = parse_rand(rng1(), period_16, pos_period_0);
 		for (size_t i = 0; i < fft_size; i++) {
 			if ((pos_period_0 >> denom_period_bits) == pos_pulse_1)
 				// - tilt by `-pi i n/N` so the frequency is shifted by 0.5.
 				// - taking the complex conjugate to adapt to inverse FFT.
-				buf1[i] = val_pulse_1 * fft->q(i << red_bits);
+				buf1[i] = val_pulse_1 * pl.q(i);
 
 			// determine the next position of the pulse.
 			if ((pos_period_0 += denom_period) >= period_16) {
@@ -810,13 +2007,12 @@ private:
 		}
 
 		// perform FFT.
-		auto ptr = fft->inv(buf1, buf2, fft_size);
+		auto ptr = pl.inv(buf1, columns);
 
 		// modify values in the frequency space.
-		auto const* const wt = wt_tbl(fft_size);
 		for (size_t i = 0; i < fft_size / 2; i++) {
 			// bias of the colored noise.
-			auto const v = wt[i] * ptr[i];
+			auto const v = w[i] * ptr[i];
 
 			// taking the complex conjugate to adapt the former inverse FFT.
 			buf1[i] = std::conj(v);
@@ -824,7 +2020,7 @@ private:
 		}
 
 		// perform inverse FFT.
-		ptr = fft->inv(buf1, buf2, fft_size);
+		ptr = pl.inv(buf1, columns);
 
 		// place the values to the destination buffer.
 		for (size_t i = 0; i < fft_size / 2; i++) {
@@ -832,7 +2028,7 @@ private:
 			// - tilt back by `pi i n/N`.
 			// - only the real part is in interest.
 			// - glue with the half of the previous section by Hann function.
-			auto const& q = fft->q(i << red_bits);
+			auto const q = pl.q(i);
 			auto const hann = q.imag() * q.imag();
 			buf[i] = hann * (
 				// \Re(q p_i)
@@ -844,6 +2040,52 @@ private:
 		}
 	}
 
+	// adds the kernel shifted to each pulse, in place of the transforms of `batch()`.
+	void batch_sparse(engine rng1, uint32_t pos_period_0)
+	{
+		auto const& pl = plan(fft_size);
+		auto const y = reinterpret_cast<float*>(fft_buf());
+		auto const* const h = pk.get();
+		std::memset(y, 0, sizeof(float) * fft_size);
+		auto [pos_pulse_1, val_pulse_1] = parse_rand(rng1(), period_16, pos_period_0);
+		for (size_t k = 0; k < fft_size; k++) {
+			if ((pos_period_0 >> denom_period_bits) == pos_pulse_1) {
+				// the part wrapped around the end of the section changes its sign.
+				auto const n = fft_size - k;
+				add_signed(y + k, h, n, val_pulse_1 < 0);
+				add_signed(y, h + n, k, val_pulse_1 > 0);
+			}
+
+			// determine the next position of the pulse.
+			if ((pos_period_0 += denom_period) >= period_16) {
+				pos_period_0 %= period_16;
+				std::tie(pos_pulse_1, val_pulse_1) = parse_rand(rng1(), period_16, pos_period_0);
+			}
+		}
+
+		// place the values to the destination buffer, in the same way as `batch()`.
+		for (size_t i = 0; i < fft_size / 2; i++) {
+			auto const j = i + fft_size / 2;
+			auto const q = pl.q(i);
+			auto const hann = q.imag() * q.imag();
+			buf[i] = hann * y[i] + buf[j];
+			buf[j] = (1 - hann) * y[j];
+		}
+	}
+
+	// adds `src` to `dst`, or subtracts if `negate`.
+	static void add_signed(float* dst, float const* src, size_t n, bool negate)
+	{
+		size_t i = 0;
+#ifdef SIGMA_LIB_PHILOX_SSE2
+		auto const sign = _mm_set1_ps(negate ? -0.0f : 0.0f);
+		for (; i + 4 <= n; i += 4)
+			_mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_xor_ps(_mm_loadu_ps(src + i), sign)));
+#endif
+		if (negate) for (; i < n; i++) dst[i] -= src[i];
+		else for (; i < n; i++) dst[i] += src[i];
+	}
+
 	constexpr static std::pair<uint32_t, float> parse_rand(uint32_t r, uint32_t period_16, uint32_t pos_period_16) {
 		auto const period = (period_16 - (pos_period_16 & (denom_period - 1))
 			+ (denom_period - 1)) >> denom_period_bits;
@@ -889,15 +2131,25 @@ static inline uint32_t calc_seed(int32_t seed, ExEdit::Filter const* efp)
 		seed ^ static_cast<uint32_t>(efp->exfunc->get_start_idx(efp->processing));
 }
 
+// calls `f` with the engine selected by `id` as the template argument.
+template<class F>
+static inline void with_engine(uint32_t id, F&& f)
+{
+	using namespace sigma_lib::rng;
+	switch (id) {
+	case noise::Exdata::engine_philox_7: return f.template operator()<philox_test::philox4x32_7>();
+	case noise::Exdata::engine_squares: return f.template operator()<squares::squares32>();
+	default: return f.template operator()<philox_test::philox4x32>();
+	}
+}
+
 struct gaussian_noise_state {
 	uint64_t pos;
-	double phase;
+	uint32_t phase; // fixed point with 32 fractional bits.
 
 	constexpr bool is_default() const { return pos == 0 && phase == 0; }
-	constexpr auto& normalize() {
-		phase = std::isfinite(phase) && 0 < phase && phase < 1 ? phase : 0;
-		return *this;
-	}
+	constexpr bool operator==(gaussian_noise_state const&) const = default;
+	constexpr auto& normalize() { return *this; }
 	constexpr void rewind_one() {
 		// rewind the state by one step to adapt read-forward behavior for interpolation.
 		pos--;
@@ -906,13 +2158,13 @@ struct gaussian_noise_state {
 
 struct velvet_noise_state {
 	uint64_t pos;
-	double phase;
+	uint32_t phase; // fixed point with 32 fractional bits.
 	uint64_t count_period;
 	double phase_period;
 
 	constexpr bool is_default() const { return pos == 0 && phase == 0 && count_period == 0 && phase_period == 0; }
+	constexpr bool operator==(velvet_noise_state const&) const = default;
 	constexpr auto& normalize() {
-		phase = std::isfinite(phase) && 0 < phase && phase < 1 ? phase : 0;
 		phase_period = std::isfinite(phase_period) && 0 < phase_period && phase_period < 1 ? phase_period : 0;
 		return *this;
 	}
@@ -979,27 +2231,416 @@ static inline std::pair<double, noise_state*> adjust_pos_phase(double hertz, ExE
 	return { delta_phase, cache == nullptr ? nullptr : &cache->curr };
 }
 
-// helper lambda to control phasing.
-static constexpr auto lambda_step_one(double& phase, double delta) {
-	return [&phase, delta](auto&... args) {
-		static_assert(sizeof...(args) % 2 == 0);
+// the generators carried over from the previous frame, kept in the cache of exedit with the space they use,
+// so that continuous playback resumes them without the warm-up of the constructors.
+// `params` tells the settings of the generators, and `state` the position they resume from.
+// exedit hands the cache as raw bytes, which it may drop or reallocate between frames, and which are
+// left uninitialized when created; so every member is trivially copyable and written as a whole,
+// and the contents are trusted only while the same cache continues with `valid` set.
+// the space larger than that of `colored_noise::max_shared_fft_size` isn't kept in the cache,
+// but left on the heap shared by the objects, which resumes only if no other has used it meanwhile.
+template<class gen, class noise_state, class params_t>
+struct generator_cache {
+	params_t params;
+	noise_state state;
+	size_t space_len;
+	uint64_t heap_ticket; // the use of the heap that this cache left.
+	bool valid;
+	float prev[2]; // the values before the current ones.
+	typename gen::resume_state gens[2];
+
+	// finds the cache for the filter, with the space of `used` floats, which is `space_used()` of the generators.
+	static generator_cache* recall(ExEdit::Filter const* efp, size_t used)
+	{
+		constexpr int row = 4096; // bytes per row of the cache.
+		auto const rows = (space_offset() + (on_heap(used) ? 0 : used) * sizeof(float) + row - 1) / row;
+		int cache_exists_flag;
+		generator_cache* const cache = reinterpret_cast<generator_cache*>(exedit.get_or_create_cache(
+			efp->processing, row / sizeof(uint64_t), static_cast<int>(rows), 8 * sizeof(uint64_t),
+			1, &cache_exists_flag));
+		if (cache == nullptr) return nullptr;
+		// the cache is of the requested size, but may be left by other parameters of the same size.
+		if (cache_exists_flag == 0 || cache->space_len != used) {
+			cache->space_len = used;
+			cache->valid = false;
+		}
+		return cache;
+	}
+	// the space for `fft_size`, which the generators resumed by this cache left as it was if `resumes()`.
+	float* space(uint32_t fft_size) {
+		if (on_heap(space_len)) return reinterpret_cast<float*>(colored_noise::heap_space(fft_size, &heap_ticket));
+		return reinterpret_cast<float*>(reinterpret_cast<std::byte*>(this) + space_offset());
+	}
+
+	// call this before `space()`.
+	bool resumes(params_t const& p, noise_state const& s) const {
+		return valid && params == p && state == s &&
+			(!on_heap(space_len) || colored_noise::heap_kept(heap_ticket));
+	}
+	// the values before the first sample, either recalled from `resumed` or read from the generator.
+	template<size_t channels>
+	static void start(gen& g, float(&prev_g)[channels], float const* resumed) {
+		if (resumed != nullptr) std::copy_n(resumed, channels, prev_g);
+		else {
+			if constexpr (channels == 1) prev_g[0] = g.value();
+			else for (size_t ch = 0; ch < channels; ch++) prev_g[ch] = g.value(ch);
+			g.move_next();
+		}
+	}
+	// keeps the generator `i` with the values before its current ones.
+	template<size_t channels>
+	void keep(size_t i, gen const& g, float const(&prev_g)[channels]) {
+		gens[i] = g.save();
+		std::copy_n(prev_g, channels, prev + i);
+	}
+	// marks the generators kept so far to resume from `s`.
+	void commit(params_t const& p, noise_state const& s) {
+		params = p;
+		state = s;
+		valid = true;
+	}
+
+private:
+	constexpr static size_t space_offset() { return (sizeof(generator_cache) + 63) & ~size_t{ 63 }; }
+	constexpr static bool on_heap(size_t used) { return used > colored_noise::space_size(colored_noise::max_shared_fft_size); }
+	static_assert(std::is_trivially_copyable_v<params_t> && std::is_trivially_copyable_v<noise_state> &&
+		std::is_trivially_copyable_v<typename gen::resume_state>);
+};
+
+// renders the values ahead on a background thread during playback, continuing from where `func_proc` left
+// the generators, so that the next frames copy them from a ring instead of rendering them.
+// the generators on the thread run on their own space and hold the shared caches they read, which are
+// never modified in place, so rendering takes no lock; the slots are locked only to pass the sources. each ring has a single producer and
+// a single consumer that `func_proc` is. the memory of a slot is released once its owner stops taking or arming,
+// and the thread sleeps while no slot is live.
+struct lookahead {
+	constexpr static size_t
+		ring_size = 1u << 15, // values per channel, some frames of playback.
+		max_frame = ring_size / 2, // frames longer than this are not rendered ahead.
+		render_chunk = 1024, // values rendered at once.
+		max_slots = 4;
+	// slots neither taken from nor armed for this long are released.
+	constexpr static auto idle_time = std::chrono::seconds{ 2 };
+
+	// the memory of a source, passed on to the next source of the slot.
+	struct buffers {
+		std::vector<float> ring{}; // the left channel, then the right.
+		std::vector<float> space{}; // the space of the generators.
+	};
+
+	// the generators rendering ahead, held by a slot, and by the thread while rendering a chunk.
+	struct source {
+		virtual ~source() = default;
+		// writes the next `n` values of each channel.
+		virtual void render(float* const (&out)[2], size_t n) = 0;
+
+		buffers memory{};
+		// the counts of the values, which the ring holds between them.
+		std::atomic<size_t> read{ 0 }, written{ 0 };
+	};
+
+	// passes the next `n` values rendered ahead for `owner` to `write(i, l, r, m)` by pieces,
+	// if the entry of the same type continues from `state` with `key`, and moves `state` past them.
+	// returns false if missed, including when the thread has not rendered them yet;
+	// then `func_proc` renders the frame itself and arms the slot again.
+	template<class entry_t>
+	static bool take(ExEdit::ObjectFilterIndex owner, typename entry_t::key_t const& key, typename entry_t::state_t& state,
+		size_t n, auto&& write)
+	{
+		if (instance == nullptr || n > max_frame) return false;
+		auto& self = *instance;
+		auto const s = self.find(owner);
+		if (s == nullptr || s->type != &type_tag<entry_t>) return false;
+		auto const src = s->get();
+		if (src == nullptr) return false;
+		s->touch();
+		auto& e = static_cast<entry_t&>(*src);
+		if (!(e.key == key && e.state == state)) return false;
+
+		auto const r = e.read.load(std::memory_order_relaxed);
+		if (e.written.load(std::memory_order_acquire) - r < n) return false;
+		auto const ring = e.memory.ring.data();
+		for (size_t i = 0; i < n;) {
+			// the values may wrap around the end of the ring.
+			auto const j = (r + i) & (ring_size - 1), m = std::min(n - i, ring_size - j);
+			write(i, ring + j, ring + ring_size + j, m);
+			i += m;
+		}
+		e.read.store(r + n, std::memory_order_release);
+		s->last_use = ++self.uses;
+		self.notify();
+
+		e.pass(n);
+		state = e.state;
+		return true;
+	}
 
-		phase += delta;
-		if (phase >= 1) {
-			phase -= std::floor(phase);
-			[&](this auto&& self, auto& gen, auto& prev, auto&... rest) {
-				prev = gen.value();
-				gen.move_next();
+	// starts rendering ahead for `owner` by `src` from the state `st` and the phase `ph`, replacing
+	// the previous one of the owner or the least recently used, and reusing the memory of that slot.
+	template<class entry_t>
+	static void arm(ExEdit::ObjectFilterIndex owner, std::unique_ptr<entry_t> src,
+		typename entry_t::state_t const& st, uint32_t ph)
+	{
+		if (instance == nullptr) instance = new lookahead{};
+		auto& self = *instance;
+		auto s = self.find(owner);
+		if (s == nullptr) s = &*std::ranges::min_element(self.slots, {}, &slot::last_use);
+
+		// the memory of the previous source, unless the thread is still rendering it.
+		{
+			std::lock_guard lock{ s->mtx };
+			auto const prev = std::move(s->src);
+			if (prev != nullptr && prev.use_count() == 1) src->memory = std::move(prev->memory);
+			else src->memory = std::move(s->spare);
+		}
+		src->memory.ring.resize(2 * ring_size);
+		src->commit(st, ph);
+
+		s->owner = owner;
+		s->type = &type_tag<entry_t>;
+		s->last_use = ++self.uses;
+		s->touch();
+		{
+			std::lock_guard lock{ s->mtx };
+			s->src = std::move(src);
+		}
+		self.notify();
+	}
 
-				if constexpr (sizeof...(rest) > 0) self(rest...);
-			}(args...);
+private:
+	using clock = std::chrono::steady_clock;
+	struct slot {
+		// `src` is replaced by `func_proc`, and cleared by the thread when idle;
+		// `spare` is left by the thread; both under `mtx`.
+		std::mutex mtx{};
+		std::shared_ptr<source> src{};
+		buffers spare{}; // the memory of a replaced source that the thread was rendering.
+		std::atomic<clock::rep> touched{ 0 }; // when `func_proc` last took from or armed this slot.
+
+		// used only by `func_proc`.
+		ExEdit::ObjectFilterIndex owner{};
+		void const* type = nullptr; // tag of the type of `src`.
+		uint64_t last_use = 0;
+
+		std::shared_ptr<source> get()
+		{
+			std::lock_guard lock{ mtx };
+			return src;
 		}
+		void touch() { touched.store(clock::now().time_since_epoch().count(), std::memory_order_relaxed); }
 	};
-}
+	slot slots[max_slots]{};
+	uint64_t uses = 0;
+
+	// the thread sleeps on `wake` until `wakes` changes.
+	std::mutex mtx{};
+	std::condition_variable wake{};
+	uint64_t wakes = 0;
+
+	template<class>
+	constexpr static char type_tag = 0;
+
+	// never destroyed; the thread is gone at the process exit,
+	// and neither joining it under the loader lock nor destroying the waited primitives is safe.
+	static inline lookahead* instance = nullptr;
+	lookahead() { std::thread{ [this] { loop(); } }.detach(); }
+
+	// the slot last armed for `owner`, whose source may have been released since.
+	slot* find(ExEdit::ObjectFilterIndex owner)
+	{
+		for (auto& s : slots) if (s.type != nullptr && s.owner == owner) return &s;
+		return nullptr;
+	}
+	void notify()
+	{
+		{
+			std::lock_guard lock{ mtx };
+			wakes++;
+		}
+		wake.notify_one();
+	}
+
+	void loop()
+	{
+		uint64_t seen = 0;
+		while (true) {
+			bool rendered = false, live = false;
+			auto const now = clock::now().time_since_epoch().count();
+			for (auto& s : slots) {
+				std::shared_ptr<source> src{}, idle{};
+				buffers idle_spare{}; // released outside the lock.
+				{
+					std::lock_guard lock{ s.mtx };
+					if (s.src != nullptr && now - s.touched.load(std::memory_order_relaxed) >
+						clock::duration{ idle_time }.count()) {
+						idle = std::move(s.src);
+						idle_spare = std::move(s.spare);
+					}
+					else src = s.src;
+				}
+				if (src == nullptr) continue;
+				live = true;
+
+				auto const w = src->written.load(std::memory_order_relaxed),
+					r = src->read.load(std::memory_order_acquire);
+				auto const j = w & (ring_size - 1),
+					m = std::min({ ring_size - (w - r), ring_size - j, render_chunk });
+				if (m > 0) {
+					auto const ring = src->memory.ring.data();
+					src->render({ ring + j, ring + ring_size + j }, m);
+					src->written.store(w + m, std::memory_order_release);
+					rendered = true;
+				}
+
+				// leave the memory to the next source if replaced meanwhile.
+				std::lock_guard lock{ s.mtx };
+				if (s.src != src) s.spare = std::move(src->memory);
+				src.reset();
+			}
+
+			// sleep until the rings are consumed or armed, checking the live slots for idleness;
+			// without them, until armed.
+			std::unique_lock lock{ mtx };
+			if (rendered || wakes != seen) {
+				seen = wakes;
+				continue;
+			}
+			auto const woken = [&] { return wakes != seen; };
+			if (live) wake.wait_for(lock, idle_time, woken);
+			else wake.wait(lock, woken);
+			seen = wakes;
+		}
+	}
+};
+
+template<class gen, class noise_state, class key_t, size_t gens_n, size_t gen_ch, class make_t>
+struct lookahead_source;
+
+// the part of the generators rendering ahead that `func_proc` reads;
+// the settings in `key`, and the state after the values taken so far.
+template<class noise_state, class key_type>
+struct lookahead_entry : lookahead::source {
+	using key_t = key_type;
+	using state_t = noise_state;
+	key_t const key;
+	noise_state state;
+
+	// the generators that `make(g, i, from)` resumes into `g`, each of `gen_ch` channels.
+	// `period` is that of velvet noise.
+	template<class gen, size_t gens_n, size_t gen_ch>
+	static auto make_source(key_t const& key, uint64_t delta, bool interpolate, double period, uint32_t fft_size, auto make)
+	{
+		return std::make_unique<lookahead_source<gen, noise_state, key_t, gens_n, gen_ch, decltype(make)>>(
+			key, delta, interpolate, period, fft_size, std::move(make));
+	}
+	// resumes from the state `s` with the phase `ph`, after the generators are kept.
+	// called by `lookahead::arm()` once `memory` is given.
+	virtual void commit(noise_state const& s, uint32_t ph) = 0;
+
+	// moves `state` past `n` values.
+	void pass(size_t n)
+	{
+		auto const steps = colored_noise::count_steps(n, phase, delta);
+		phase = static_cast<uint32_t>(phase + n * delta);
+		pos += steps;
+		if constexpr (std::same_as<noise_state, velvet_noise_state>) {
+			auto const phase_period = velvet_noise_base::step_period(period, steps, count_period, pos_period_16);
+			state = { pos, phase, count_period, phase_period };
+			state.rewind_one(period);
+		}
+		else {
+			state = { pos, phase };
+			state.rewind_one();
+		}
+	}
+
+protected:
+	lookahead_entry(key_t const& key, uint64_t delta, double period)
+		: key{ key }, state{}, delta{ delta }, period{ period } {}
+
+	// the position of the generators after the values taken so far, the counters of the periods for velvet noise.
+	uint_fast64_t pos = 0, count_period = 0;
+	uint32_t pos_period_16 = 0, phase = 0;
+	uint64_t const delta;
+	double const period;
+};
+
+// the generators rendering ahead on their own space, holding the shared caches of their parameters,
+// resumed from the ones that `func_proc` kept by `keep()` and `commit()`. see `lookahead_entry::make_source()`.
+template<class gen, class noise_state, class key_t, size_t gens_n, size_t gen_ch, class make_t>
+struct lookahead_source : lookahead_entry<noise_state, key_t> {
+	static_assert(gens_n * gen_ch <= 2);
+	using base = lookahead_entry<noise_state, key_t>;
+
+	lookahead_source(key_t const& key, uint64_t delta, bool interpolate, double period, uint32_t fft_size, make_t make)
+		: base{ key, delta, period }, interpolate{ interpolate }, fft_size{ fft_size }, make{ std::move(make) } {}
+
+	// keeps the generator `i` with the values before its current ones.
+	void keep(size_t i, gen const& g, float const(&prev_g)[gen_ch])
+	{
+		saved[i].emplace(g.save());
+		live[i] = g.live_space();
+		std::copy_n(prev_g, gen_ch, prev[i]);
+		if (i > 0) return;
+		this->pos = g.pos;
+		if constexpr (std::same_as<noise_state, velvet_noise_state>) {
+			this->count_period = saved[0]->count_period;
+			this->pos_period_16 = saved[0]->pos_period_16;
+		}
+	}
+	// resumes from the state `s` with the phase `ph`, on a copy of the parts of the space
+	// that the generators kept so far carry over; the scratch is left as it was.
+	void commit(noise_state const& s, uint32_t ph) override
+	{
+		this->state = s;
+		this->phase = render_phase = ph;
+		auto& space = this->memory.space;
+		space.resize(colored_noise::space_size(fft_size));
+		auto const src = reinterpret_cast<float const*>(colored_noise::memory_ptr);
+		for (auto const& l : live) {
+			if (!l.empty()) std::copy(l.begin(), l.end(), space.data() + (l.data() - src));
+		}
+
+		// construct the generators on the copy, while the shared caches are of their parameters.
+		auto const mem = std::exchange(colored_noise::memory_ptr, space.data());
+		for (size_t i = 0; i < gens_n; i++) make(gens[i], i, &*saved[i]);
+		colored_noise::memory_ptr = mem;
+	}
+
+	void render(float* const (&out)[2], size_t n) override
+	{
+		colored_noise::memory_ptr = this->memory.space.data();
+		uint32_t ph = render_phase;
+		for (size_t i = 0; i < gens_n; i++) {
+			// the generators step by the same phase.
+			float* dst[gen_ch];
+			for (size_t c = 0; c < gen_ch; c++) dst[c] = out[i * gen_ch + c];
+			ph = render_phase;
+			gens[i]->fill(dst, prev[i], n, ph, this->delta, interpolate);
+		}
+		render_phase = ph;
+	}
+
+private:
+	bool const interpolate;
+	uint32_t const fft_size;
+	make_t const make;
+	std::optional<typename gen::resume_state> saved[gens_n];
+	std::span<float const> live[gens_n]; // see `live_space()` of the generators.
+	float prev[gens_n][gen_ch];
+	uint32_t render_phase = 0; // the phase of the generators, apart from the one `pass()` moves.
+	std::optional<gen> gens[gens_n];
+};
 
 // find a suitable address to the space for noise calculations.
-static void set_noise_gen_space(ExEdit::FilterProcInfo* efpip)
+static void set_noise_gen_space(ExEdit::FilterProcInfo* efpip, uint32_t fft_size)
 {
+	// the shared memory may be too small for large FFT sizes.
+	if (fft_size > colored_noise::max_shared_fft_size) {
+		colored_noise::memory_ptr = colored_noise::heap_space(fft_size);
+		return;
+	}
+
 	// *exedit.memory_ptr can be used as efpip->audio_p
 	// (specifically when `obj.getaudio()` is called).
 	// find the alternative for that case.
@@ -1017,6 +2658,146 @@ static void apply_volume(float volume, int16_t* st, int16_t const* ed)
 }
 static void apply_volume(float volume, int16_t* st, int count) { apply_volume(volume, st, st + count); }
 
+#ifdef SIGMA_LIB_PHILOX_SSE2
+// `noise::to_int_t()` of four values, rounding halves away from zero as `std::lround()` does.
+template<int std_height>
+static __m128i to_int_simd(float const* src)
+{
+	using lim = std::numeric_limits<int16_t>;
+	auto const y = _mm_min_ps(_mm_max_ps(
+		_mm_mul_ps(_mm_loadu_ps(src), _mm_set1_ps(static_cast<float>(std_height))),
+		_mm_set1_ps(lim::min())), _mm_set1_ps(lim::max()));
+	// truncate, and round the fraction; the masks are -1 where true.
+	auto const i = _mm_cvttps_epi32(y);
+	auto const f = _mm_sub_ps(y, _mm_cvtepi32_ps(i));
+	return _mm_add_epi32(
+		_mm_sub_epi32(i, _mm_castps_si128(_mm_cmpge_ps(f, _mm_set1_ps(0.5f)))),
+		_mm_castps_si128(_mm_cmple_ps(f, _mm_set1_ps(-0.5f))));
+}
+#endif
+
+// number of samples drawn at once from the generators by `func_proc`.
+constexpr size_t samples_chunk = 256;
+
+// `noise::to_int_t()` of the values, to the monaural samples.
+template<int std_height>
+static void to_int_samples(int16_t* dst, float const* src, size_t n)
+{
+	size_t i = 0;
+#ifdef SIGMA_LIB_PHILOX_SSE2
+	for (; i + 8 <= n; i += 8)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+			_mm_packs_epi32(to_int_simd<std_height>(src + i), to_int_simd<std_height>(src + i + 4)));
+#endif
+	for (; i < n; i++) dst[i] = noise::to_int_t<std_height>(src[i]);
+}
+// to the interleaved stereo samples. `src_r` may be the same as `src_l`.
+template<int std_height>
+static void to_int_samples(int16_t* dst, float const* src_l, float const* src_r, size_t n)
+{
+	size_t i = 0;
+#ifdef SIGMA_LIB_PHILOX_SSE2
+	for (; i + 8 <= n; i += 8) {
+		auto const
+			l = _mm_packs_epi32(to_int_simd<std_height>(src_l + i), to_int_simd<std_height>(src_l + i + 4)),
+			r = _mm_packs_epi32(to_int_simd<std_height>(src_r + i), to_int_simd<std_height>(src_r + i + 4));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), _mm_unpacklo_epi16(l, r));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 8), _mm_unpackhi_epi16(l, r));
+	}
+#endif
+	for (; i < n; i++) {
+		dst[2 * i + 0] = noise::to_int_t<std_height>(src_l[i]);
+		dst[2 * i + 1] = noise::to_int_t<std_height>(src_r[i]);
+	}
+}
+
+// the settings of the gaussian noise, on which the generators depend.
+struct gaussian_params {
+	uint32_t engine_id;
+	float alpha;
+	uint32_t fft_size, method, sampler, seed;
+	bool stereo; // a single generator for both channels.
+
+	constexpr bool operator==(gaussian_params const&) const = default;
+};
+
+// renders the gaussian noise of `efpip->audio_n` samples for `noise` and `noise_multiply`,
+// passing the values of `m` samples from `i` to `write(i, l, r, m)`; `r` is of the right channel if `p.stereo`.
+// continues from `*state_ptr` and moves it if not null, taking the values rendered ahead if `look_ahead`.
+static void render_gaussian(ExEdit::Filter const* efp, ExEdit::FilterProcInfo* efpip, gaussian_params const& p,
+	gaussian_noise_state* state_ptr, uint64_t phase_step, bool interpolate, bool look_ahead, auto const& write)
+{
+	auto const [engine_id, alpha, fft_size, method, sampler, seed, stereo_gen] = p;
+	auto const state = state_ptr != nullptr ? *state_ptr : gaussian_noise_state{};
+	auto [pos, phase] = state;
+	size_t const n = efpip->audio_n;
+	bool const ahead = look_ahead && state_ptr != nullptr && n <= lookahead::max_frame;
+	with_engine(engine_id, [&]<class engine>() {
+		using gen_t = gaussian_noise<engine>;
+
+		// take the values rendered ahead if they continue from the previous frame.
+		auto const key = std::tuple{ p, phase_step, interpolate };
+		using entry_t = lookahead_entry<gaussian_noise_state, decltype(key)>;
+		if (ahead && lookahead::take<entry_t>(efp->processing, key, *state_ptr, n, write)) return;
+		std::unique_ptr<entry_t> src{};
+
+		// resume the generator if continuing from the previous frame.
+		using cache_t = generator_cache<gen_t, gaussian_noise_state, gaussian_params>;
+		auto const cache = state_ptr != nullptr ?
+			cache_t::recall(efp, gen_t::space_used(alpha, fft_size, method)) : nullptr;
+		bool const resume = cache != nullptr && cache->resumes(p, state);
+		if (cache != nullptr) colored_noise::memory_ptr = cache->space(fft_size);
+		else set_noise_gen_space(efpip, fft_size);
+
+		// draws the values from `gen` of `channels` channels, and keeps it to resume from the end.
+		auto run = [&]<size_t channels>(gen_t& gen, auto make) {
+			float prev[channels];
+			cache_t::start(gen, prev, resume ? cache->prev : nullptr);
+
+			// write values to the buffer.
+			float vals[2][samples_chunk];
+			for (size_t i = 0; i < n; i += samples_chunk) {
+				auto const m = std::min(n - i, samples_chunk);
+				if constexpr (channels == 2) gen.fill({ vals[0], vals[1] }, prev, m, phase, phase_step, interpolate);
+				else gen.fill({ vals[0] }, prev, m, phase, phase_step, interpolate);
+				write(i, vals[0], vals[channels - 1], m);
+			}
+
+			// update the position.
+			pos = gen.pos;
+			if (cache != nullptr) cache->keep(0, gen, prev);
+			if (ahead) {
+				auto s = entry_t::template make_source<gen_t, 1, channels>(key, phase_step, interpolate, 0, fft_size, make);
+				s->keep(0, gen, prev);
+				src = std::move(s);
+			}
+		};
+		if (stereo_gen) {
+			// prepare a noise generator for both channels.
+			gen_t gen{ gen_t::stereo_tag, alpha, fft_size, method, sampler, seed, ~seed, pos,
+				resume ? &cache->gens[0] : nullptr };
+			run.template operator()<2>(gen, [=](auto& g, size_t, auto from) {
+				g.emplace(gen_t::stereo_tag, alpha, fft_size, method, sampler, seed, ~seed, 0, from); });
+		}
+		else {
+			// prepare a noise generator.
+			gen_t gen{ alpha, fft_size, method, sampler, seed, pos, 0,
+				resume ? &cache->gens[0] : nullptr };
+			run.template operator()<1>(gen, [=](auto& g, size_t, auto from) {
+				g.emplace(alpha, fft_size, method, sampler, seed, 0, 0, from); });
+		}
+
+		// store the phase and the position for the next use,
+		// and the generator to resume from there.
+		if (state_ptr != nullptr) {
+			*state_ptr = { pos, phase };
+			state_ptr->rewind_one();
+			if (cache != nullptr) cache->commit(p, *state_ptr);
+			if (src != nullptr) lookahead::arm(efp->processing, std::move(src), *state_ptr, phase);
+		}
+	});
+}
+
 BOOL noise::func_proc(ExEdit::Filter* efp, ExEdit::FilterProcInfo* efpip)
 {
 	int constexpr
@@ -1048,69 +2829,26 @@ BOOL noise::func_proc(ExEdit::Filter* efp, ExEdit::FilterProcInfo* efpip)
 		back_volume	= std::clamp(raw_back, min_back, max_back) / static_cast<float>(100 * den_back);
 	uint32_t const
 		seed		= calc_seed(exdata->seed, efp),
-		fft_size	= exdata->clamped_fft_size();
+		fft_size	= exdata->clamped_fft_size(),
+		method		= exdata->clamped_method(),
+		sampler		= exdata->clamped_sampler(),
+		engine_id	= exdata->clamped_engine();
 
 	// recall previous state.
 	auto [delta_phase, state_ptr] = adjust_pos_phase<gaussian_noise_state>(hertz, efp, efpip);
-	auto [pos, phase] = state_ptr != nullptr ? *state_ptr : std::decay_t<decltype(*state_ptr)>{};
-	constexpr double const_0 = 0;
-	double const& phase_ref = interpolate ? phase : const_0;
 
 	// generate noise.
 	double const delta_phase_corr = raw_freq >= max_freq ? 1.0 : std::min(delta_phase, 1.0);
-	auto step_one = lambda_step_one(phase, delta_phase_corr);
-	auto val = [&phase_ref](gaussian_noise const& gen, float prev) {
-		auto const t = static_cast<float>(phase_ref);
-		return to_int((1 - t) * prev + t * gen.value());
-	};
-	set_noise_gen_space(efpip);
+	bool const stereo_gen = stereo && efpip->audio_ch == 2;
 	int16_t* const data = efpip->audio_data;
-	if (stereo && efpip->audio_ch == 2) {
-		// prepare two noise generators.
-		gaussian_noise
-			genL{ alpha, fft_size, seed, pos },
-			genR{ alpha, fft_size, ~seed, pos, 1 };
-		float prevL = genL.value(), prevR = genR.value();
-		genL.move_next(); genR.move_next();
-
-		// write values to the buffer.
-		for (int i = 0; i < efpip->audio_n; i++) {
-			step_one(genL, prevL, genR, prevR);
-			data[2 * i + 0] = val(genL, prevL);
-			data[2 * i + 1] = val(genR, prevR);
-		}
-
-		// update the position.
-		pos = genL.pos;
-	}
-	else {
-		// prepare a noise generator.
-		gaussian_noise gen{ alpha, fft_size, seed, pos };
-		float prev = gen.value(); gen.move_next();
-
-		// write values to the buffer.
-		if (efpip->audio_ch == 2) {
-			for (int i = 0; i < efpip->audio_n; i++) {
-				step_one(gen, prev);
-				data[2 * i] = data[2 * i + 1] = val(gen, prev);
-			}
-		}
-		else {
-			for (int i = 0; i < efpip->audio_n; i++) {
-				step_one(gen, prev);
-				data[i] = val(gen, prev);
-			}
-		}
-
-		// update the position.
-		pos = gen.pos;
-	}
-
-	// store the phase and the position for the next use.
-	if (state_ptr != nullptr) {
-		*state_ptr = { pos, phase };
-		state_ptr->rewind_one();
-	}
+	render_gaussian(efp, efpip, { engine_id, alpha, fft_size, method, sampler, seed, stereo_gen },
+		state_ptr, colored_noise::phase_delta(delta_phase_corr), interpolate, exdata->clamped_lookahead() != 0,
+		// writes the values of `m` samples from `i`; `r` is of the right channel if `stereo_gen`.
+		[&](size_t i, float const* l, float const* r, size_t m) {
+			if (stereo_gen) to_int_samples<std_height>(data + 2 * i, l, r, m);
+			else if (efpip->audio_ch == 2) to_int_samples<std_height>(data + 2 * i, l, l, m);
+			else to_int_samples<std_height>(data + i, l, m);
+		});
 
 	// lower (or possibly gain) the sound already rendered.
 	if (back_volume != 1.0f)
@@ -1160,21 +2898,17 @@ BOOL noise_multiply::func_proc(ExEdit::Filter* efp, ExEdit::FilterProcInfo* efpi
 			calc_volume(std::clamp(raw_lbound, min_bound, max_bound) / static_cast<double>(den_bound));
 	uint32_t const
 		seed		= calc_seed(exdata->seed, efp),
-		fft_size	= exdata->clamped_fft_size();
+		fft_size	= exdata->clamped_fft_size(),
+		method		= exdata->clamped_method(),
+		sampler		= exdata->clamped_sampler(),
+		engine_id	= exdata->clamped_engine();
 
 	// recall previous state.
 	auto [delta_phase, state_ptr] = adjust_pos_phase<gaussian_noise_state>(hertz, efp, efpip);
-	auto [pos, phase] = state_ptr != nullptr ? *state_ptr : std::decay_t<decltype(*state_ptr)>{};
-	constexpr double const_0 = 0;
-	double const& phase_ref = interpolate ? phase : const_0;
 
 	// filter by noise.
 	double const delta_phase_corr = raw_freq >= max_freq ? 1.0 : std::min(delta_phase, 1.0);
-	auto step_one = lambda_step_one(phase, delta_phase_corr);
-	auto val = [&phase_ref](gaussian_noise const& gen, float prev) {
-		auto const t = static_cast<float>(phase_ref);
-		return (1 - t) * prev + t * gen.value();
-	};
+	bool const stereo_gen = stereo && efpip->audio_ch == 2;
 	auto bound = [=, dyn_range = std::max(u_bound - l_bound, 0.0f)](float noise) {
 		auto const ret = dyn_range <= 0 ?
 			std::abs(noise) <= l_bound ? 0.0f : 1.0f :
@@ -1185,59 +2919,42 @@ BOOL noise_multiply::func_proc(ExEdit::Filter* efp, ExEdit::FilterProcInfo* efpi
 		float const rate = (1 - intensity) + intensity * bound(noise);
 		((signal = static_cast<int16_t>(std::lround(rate * signal))), ...);
 	};
-	set_noise_gen_space(efpip);
 	int16_t* const data = has_flag_or(efp->flag, ExEdit::Filter::Flag::Effect) ?
 		efpip->audio_data : efpip->audio_p;
-	if (stereo && efpip->audio_ch == 2) {
-		// prepare two noise generators.
-		gaussian_noise
-			genL{ alpha, fft_size, seed, pos },
-			genR{ alpha, fft_size, ~seed, pos, 1 };
-		float prevL = genL.value(), prevR = genR.value();
-		genL.move_next(); genR.move_next();
-
-		// write values to the buffer.
-		for (int i = 0; i < efpip->audio_n; i++) {
-			step_one(genL, prevL, genR, prevR);
-			mix(val(genL, prevL), data[2 * i + 0]);
-			mix(val(genR, prevR), data[2 * i + 1]);
-		}
-
-		// update the position.
-		pos = genL.pos;
-	}
-	else {
-		// prepare a noise generator.
-		gaussian_noise gen{ alpha, fft_size, seed, pos };
-		float prev = gen.value(); gen.move_next();
-
-		// write values to the buffer.
-		if (efpip->audio_ch == 2) {
-			for (int i = 0; i < efpip->audio_n; i++) {
-				step_one(gen, prev);
-				mix(val(gen, prev), data[2 * i], data[2 * i + 1]);
+	render_gaussian(efp, efpip, { engine_id, alpha, fft_size, method, sampler, seed, stereo_gen },
+		state_ptr, colored_noise::phase_delta(delta_phase_corr), interpolate, exdata->clamped_lookahead() != 0,
+		// applies the values of `m` samples from `i`; `r` is of the right channel if `stereo_gen`.
+		[&](size_t i, float const* l, float const* r, size_t m) {
+			if (stereo_gen) {
+				for (size_t j = 0; j < m; j++) {
+					mix(l[j], data[2 * (i + j) + 0]);
+					mix(r[j], data[2 * (i + j) + 1]);
+				}
 			}
-		}
-		else {
-			for (int i = 0; i < efpip->audio_n; i++) {
-				step_one(gen, prev);
-				mix(val(gen, prev), data[i]);
+			else if (efpip->audio_ch == 2) {
+				for (size_t j = 0; j < m; j++)
+					mix(l[j], data[2 * (i + j)], data[2 * (i + j) + 1]);
 			}
-		}
-
-		// update the position.
-		pos = gen.pos;
-	}
-
-	// store the phase and the position for the next use.
-	if (state_ptr != nullptr) {
-		*state_ptr = { pos, phase };
-		state_ptr->rewind_one();
-	}
+			else {
+				for (size_t j = 0; j < m; j++)
+					mix(l[j], data[i + j]);
+			}
+		});
 
 	return TRUE;
 }
 
+// the settings of the velvet noise, on which the generators depend.
+struct velvet_params {
+	uint32_t engine_id;
+	double period;
+	float alpha;
+	uint32_t fft_size, seed;
+	bool stereo; // a generator for each channel.
+
+	constexpr bool operator==(velvet_params const&) const = default;
+};
+
 BOOL velvet::func_proc(ExEdit::Filter* efp, ExEdit::FilterProcInfo* efpip)
 {
 	int constexpr
@@ -1275,76 +2992,118 @@ BOOL velvet::func_proc(ExEdit::Filter* efp, ExEdit::FilterProcInfo* efpip)
 		back_volume	= std::clamp(raw_back, min_back, max_back) / static_cast<float>(100 * den_back);
 	uint32_t const
 		seed		= calc_seed(exdata->seed, efp),
-		fft_size	= exdata->clamped_fft_size();
+		fft_size	= exdata->clamped_fft_size(),
+		engine_id	= exdata->clamped_engine();
 
 	// recall previous state.
 	auto [delta_phase, state_ptr] = adjust_pos_phase<velvet_noise_state>(hertz, efp, efpip);
-	auto [pos, phase, count_period, phase_period] = state_ptr != nullptr ? *state_ptr : std::decay_t<decltype(*state_ptr)>{};
-	constexpr double const_0 = 0;
-	double const& phase_ref = interpolate ? phase : const_0;
+	auto const state = state_ptr != nullptr ? *state_ptr : std::decay_t<decltype(*state_ptr)>{};
+	auto [pos, phase, count_period, phase_period] = state;
 
 	// generate noise.
 	double const
 		delta_phase_corr = raw_freq >= max_freq ? 1.0 : std::min(delta_phase, 1.0),
 		period = raw_fuzzy >= max_fuzzy ? 1 :
 			std::max(delta_phase_corr * efpip->audio_rate / taps_hertz, 1.0);
-	auto step_one = lambda_step_one(phase, delta_phase_corr);
-	auto val = [&phase_ref](velvet_noise const& gen, float prev) {
-		auto const t = static_cast<float>(phase_ref);
-		return to_int((1 - t) * prev + t * gen.value());
-	};
-	set_noise_gen_space(efpip);
+	uint64_t const phase_step = colored_noise::phase_delta(delta_phase_corr);
+	bool const stereo_gen = stereo && efpip->audio_ch == 2;
 	int16_t* const data = efpip->audio_data;
-	if (stereo && efpip->audio_ch == 2) {
-		// prepare two noise generators.
-		velvet_noise
-			genL{ period, alpha, fft_size, seed, pos, count_period, phase_period },
-			genR{ period, alpha, fft_size, ~seed, pos, count_period, phase_period, 1 };
-		float prevL = genL.value(), prevR = genR.value();
-		genL.move_next(); genR.move_next();
-
-		// write values to the buffer.
-		for (int i = 0; i < efpip->audio_n; i++) {
-			step_one(genL, prevL, genR, prevR);
-			data[2 * i + 0] = val(genL, prevL);
-			data[2 * i + 1] = val(genR, prevR);
-		}
-
-		// update the states.
-		pos = genL.pos;
-		count_period = genL.count_period;
-		phase_period = genL.phase_period();
-	}
-	else {
-		// prepare a noise generator.
-		velvet_noise gen{ period, alpha, fft_size, seed, pos, count_period, phase_period };
-		float prev = gen.value(); gen.move_next();
-
-		// write values to the buffer.
-		if (efpip->audio_ch == 2) {
-			for (int i = 0; i < efpip->audio_n; i++) {
-				step_one(gen, prev);
-				data[2 * i] = data[2 * i + 1] = val(gen, prev);
+	size_t const n = efpip->audio_n;
+	bool const ahead = exdata->clamped_lookahead() != 0 && state_ptr != nullptr && n <= lookahead::max_frame;
+	with_engine(engine_id, [&]<class engine>() {
+		using gen_t = velvet_noise<engine>;
+		auto const params = velvet_params{ engine_id, period, alpha, fft_size, seed, stereo_gen };
+
+		// writes the values of `m` samples from `i`; `r` is of the right channel if `stereo_gen`.
+		auto const write = [&](size_t i, float const* l, float const* r, size_t m) {
+			if (stereo_gen) to_int_samples<std_height>(data + 2 * i, l, r, m);
+			else if (efpip->audio_ch == 2) to_int_samples<std_height>(data + 2 * i, l, l, m);
+			else to_int_samples<std_height>(data + i, l, m);
+		};
+
+		// take the values rendered ahead if they continue from the previous frame.
+		auto const key = std::tuple{ params, phase_step, interpolate };
+		using entry_t = lookahead_entry<velvet_noise_state, decltype(key)>;
+		if (ahead && lookahead::take<entry_t>(efp->processing, key, *state_ptr, n, write)) return;
+		std::unique_ptr<entry_t> src{};
+
+		// resume the generators if continuing from the previous frame.
+		using cache_t = generator_cache<gen_t, velvet_noise_state, velvet_params>;
+		auto const cache = state_ptr != nullptr ? cache_t::recall(efp, gen_t::space_used(alpha, fft_size)) : nullptr;
+		bool const resume = cache != nullptr && cache->resumes(params, state);
+		if (cache != nullptr) colored_noise::memory_ptr = cache->space(fft_size);
+		else set_noise_gen_space(efpip, fft_size);
+
+		float vals[2][samples_chunk];
+		if (stereo_gen) {
+			// prepare two noise generators.
+			gen_t
+				genL{ period, alpha, fft_size, seed, pos, count_period, phase_period, 0,
+					resume ? &cache->gens[0] : nullptr },
+				genR{ period, alpha, fft_size, ~seed, pos, count_period, phase_period, 1,
+					resume ? &cache->gens[1] : nullptr };
+			float prevL[1], prevR[1];
+			cache_t::start(genL, prevL, resume ? cache->prev : nullptr);
+			cache_t::start(genR, prevR, resume ? cache->prev + 1 : nullptr);
+
+			// write values to the buffer.
+			// the two generators step by the same phase.
+			for (size_t i = 0; i < n; i += samples_chunk) {
+				auto const m = std::min(n - i, samples_chunk);
+				uint32_t phase_r = phase;
+				genL.fill({ vals[0] }, prevL, m, phase, phase_step, interpolate);
+				genR.fill({ vals[1] }, prevR, m, phase_r, phase_step, interpolate);
+				write(i, vals[0], vals[1], m);
+			}
+
+			// update the states.
+			pos = genL.pos;
+			count_period = genL.count_period;
+			phase_period = genL.phase_period();
+			if (cache != nullptr) { cache->keep(0, genL, prevL); cache->keep(1, genR, prevR); }
+			if (ahead) {
+				auto s = entry_t::template make_source<gen_t, 2, 1>(key, phase_step, interpolate, period, fft_size,
+					[=](auto& g, size_t i, auto from) { g.emplace(period, alpha, fft_size, i == 0 ? seed : ~seed, 0, 0, 0.0, i, from); });
+				s->keep(0, genL, prevL); s->keep(1, genR, prevR);
+				src = std::move(s);
 			}
 		}
 		else {
-			for (int i = 0; i < efpip->audio_n; i++) {
-				step_one(gen, prev);
-				data[i] = val(gen, prev);
+			// prepare a noise generator.
+			gen_t gen{ period, alpha, fft_size, seed, pos, count_period, phase_period, 0,
+				resume ? &cache->gens[0] : nullptr };
+			float prev[1];
+			cache_t::start(gen, prev, resume ? cache->prev : nullptr);
+
+			// write values to the buffer.
+			for (size_t i = 0; i < n; i += samples_chunk) {
+				auto const m = std::min(n - i, samples_chunk);
+				gen.fill({ vals[0] }, prev, m, phase, phase_step, interpolate);
+				write(i, vals[0], vals[0], m);
 			}
-		}
 
-		// update the states.
-		pos = gen.pos;
-		count_period = gen.count_period;
-		phase_period = gen.phase_period();
-	}
+			// update the states.
+			pos = gen.pos;
+			count_period = gen.count_period;
+			phase_period = gen.phase_period();
+			if (cache != nullptr) cache->keep(0, gen, prev);
+			if (ahead) {
+				auto s = entry_t::template make_source<gen_t, 1, 1>(key, phase_step, interpolate, period, fft_size,
+					[=](auto& g, size_t, auto from) { g.emplace(period, alpha, fft_size, seed, 0, 0, 0.0, 0, from); });
+				s->keep(0, gen, prev);
+				src = std::move(s);
+			}
+		}
 
-	// store the states for the next use.
-	if (state_ptr != nullptr) {
-		*state_ptr = { pos, phase, count_period, phase_period };
-		state_ptr->rewind_one(period);
-	}
+		// store the states for the next use,
+		// and the generators to resume from there.
+		if (state_ptr != nullptr) {
+			*state_ptr = { pos, phase, count_period, phase_period };
+			state_ptr->rewind_one(period);
+			if (cache != nullptr) cache->commit(params, *state_ptr);
+			if (src != nullptr) lookahead::arm(efp->processing, std::move(src), *state_ptr, phase);
+		}
+	});
 
 	// lower (or possibly gain) the sound already rendered.
 	if (back_volume != 1.0f)
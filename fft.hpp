@@ -10,12 +10,23 @@ The above copyright notice and this permission notice shall be included in all c
 THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
+
 #pragma once
 
 #include <numbers>
+#include <algorithm>
 #include <complex>
 #include <bit>
 #include <concepts>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIGMA_LIB_FFT_SSE2
+#endif
 
 
 namespace sigma_lib::fft
@@ -25,6 +36,84 @@ namespace sigma_lib::fft
 		constexpr auto flat_loop = [](size_t N, std::invocable<size_t const> auto&& lambda) -> void {
 			for (size_t i = 0; i < N; i++) lambda(i);
 		};
+		// the loop over the column groups of the four-step algorithm;
+		// calls `lambda(i, lane)` for each `i < N`, where `lane` is less than the lanes of the plan.
+		// a parallel one must return only after all the calls have finished.
+		constexpr auto flat_columns = [](size_t N, std::invocable<size_t const, size_t const> auto&& lambda) -> void {
+			for (size_t i = 0; i < N; i++) lambda(i, 0);
+		};
+
+		// cos(pi x) and sin(pi x) by the Taylor series, accurate enough for |x| <= 1/4.
+		// usable at compile time, unlike std::cos() and std::sin().
+		constexpr std::pair<double, double> cos_sin_pi(double x) {
+			double const t = std::numbers::pi * x, t2 = t * t;
+			double c = 1, s = 1;
+			for (int k = 20; k > 0; k -= 2) {
+				c = 1 - c * t2 / (k * (k - 1));
+				s = 1 - s * t2 / ((k + 1) * k);
+			}
+			return { c, s * t };
+		}
+
+		// reverses the lower `bits` bits of `n`.
+		constexpr size_t bit_reverse(size_t n, size_t bits) {
+			size_t r = 0;
+			for (size_t i = 0; i < bits; i++, n >>= 1) r = (r << 1) | (n & 1);
+			return r;
+		}
+
+		// multiplies by `i`, or by `-i` for the forward transform.
+		template<bool inverse, std::floating_point T>
+		constexpr std::complex<T> mul_i(std::complex<T> const& x) {
+			return inverse ? std::complex<T>{ -x.imag(), x.real() } : std::complex<T>{ x.imag(), -x.real() };
+		}
+
+#ifdef SIGMA_LIB_FFT_SSE2
+		// two complex numbers of float packed in a register, as { re0, im0, re1, im1 }.
+		struct cpx2 {
+			using cpx = std::complex<float>;
+			__m128 v;
+
+			static cpx2 load(cpx const* p) { return { _mm_loadu_ps(reinterpret_cast<float const*>(p)) }; }
+			static cpx2 load(cpx const* p0, cpx const* p1) {
+				return { _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(),
+					reinterpret_cast<__m64 const*>(p0)), reinterpret_cast<__m64 const*>(p1)) };
+			}
+			static cpx2 broadcast(cpx const& z) {
+				return { _mm_castpd_ps(_mm_load1_pd(reinterpret_cast<double const*>(&z))) };
+			}
+			void store(cpx* p) const { _mm_storeu_ps(reinterpret_cast<float*>(p), v); }
+			// stores the lower and the upper halves respectively.
+			void store(cpx* p0, cpx* p1) const {
+				_mm_storel_pi(reinterpret_cast<__m64*>(p0), v);
+				_mm_storeh_pi(reinterpret_cast<__m64*>(p1), v);
+			}
+
+			friend cpx2 operator+(cpx2 const& a, cpx2 const& b) { return { _mm_add_ps(a.v, b.v) }; }
+			friend cpx2 operator-(cpx2 const& a, cpx2 const& b) { return { _mm_sub_ps(a.v, b.v) }; }
+			friend cpx2 operator*(cpx2 const& a, float h) { return { _mm_mul_ps(a.v, _mm_set1_ps(h)) }; }
+			friend cpx2 operator*(cpx2 const& a, cpx2 const& w) {
+				auto const
+					re = _mm_shuffle_ps(w.v, w.v, _MM_SHUFFLE(2, 2, 0, 0)),
+					im = _mm_shuffle_ps(w.v, w.v, _MM_SHUFFLE(3, 3, 1, 1)),
+					sw = _mm_shuffle_ps(a.v, a.v, _MM_SHUFFLE(2, 3, 0, 1));
+				return { _mm_add_ps(_mm_mul_ps(a.v, re),
+					_mm_xor_ps(_mm_mul_ps(sw, im), _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f))) };
+			}
+			friend cpx2 operator*(cpx const& w, cpx2 const& a) { return a * broadcast(w); }
+			friend cpx2 conj(cpx2 const& a) { return { _mm_xor_ps(a.v, _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)) }; }
+
+			// packs the lower halves of `a` and `b`, and the upper halves respectively.
+			friend cpx2 lo_lo(cpx2 const& a, cpx2 const& b) { return { _mm_movelh_ps(a.v, b.v) }; }
+			friend cpx2 hi_hi(cpx2 const& a, cpx2 const& b) { return { _mm_movehl_ps(b.v, a.v) }; }
+		};
+		template<bool inverse>
+		inline cpx2 mul_i(cpx2 const& x) {
+			auto const sw = _mm_shuffle_ps(x.v, x.v, _MM_SHUFFLE(2, 3, 0, 1));
+			return { _mm_xor_ps(sw, inverse ?
+				_mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f) : _mm_setr_ps(0.0f, -0.0f, 0.0f, -0.0f)) };
+		}
+#endif
 	}
 	template<size_t max_N, std::floating_point base_float = float, auto do_loop = detail::flat_loop>
 		requires(max_N > 2 && std::popcount(max_N) == 1)
@@ -36,7 +125,17 @@ namespace sigma_lib::fft
 
 	private:
 		constexpr static size_t max_bits = std::bit_width(max_size) - 1;
+#ifdef SIGMA_LIB_FFT_SSE2
+		constexpr static bool simd_enabled = std::same_as<base_float, float>;
+#endif
 		cpx Q[max_size / 2];
+		// twiddle factors of the radix-4 passes, laid out contiguously for each stage;
+		// those for the pass from `b` to `4b` start at W[3b]. see `stage_twiddles()`.
+		cpx W[3 * (max_size / 2)];
+		// tilting factors for each length `S`, where P[S + n] = \e(n/(2S)).
+		cpx P[2 * max_size];
+		// bit-reversal permutation for the in-place transforms.
+		std::conditional_t<(max_size <= (1u << 16)), uint16_t, uint32_t> R[max_size];
 		constexpr static bool is_size_valid(size_t N) {
 			// assuming max_size is a power of 2,
 			// the below is equivalent to: N > 0 && max_size % N == 0.
@@ -44,64 +143,59 @@ namespace sigma_lib::fft
 		}
 
 	public:
+		// all the tables are computed at compile time if declared `constexpr`.
 		constexpr FFT()
 		{
-			constexpr auto pi = std::numbers::pi_v<base_float>;
-			do_loop(max_size / 4, [this](size_t const n) {
-				auto const arg = 2 * pi * n / max_size;
-				auto const re = std::cos(arg), im = std::sin(arg);
-				// q[n] = \e(n/N), where \e(z) = exp(2 pi i z).
-				Q[n] = { re, im };
-				Q[n + max_size / 4] = { -im, re };
+			// P[max_size + n] = \e(n/(2 max_size)), where \e(z) = exp(2 pi i z).
+			// only the first octant is calculated, and the rest follows by symmetry.
+			auto const P0 = P + max_size;
+			do_loop(max_size / 4 + 1, [P0](size_t const n) {
+				auto const [re, im] = detail::cos_sin_pi(static_cast<double>(n) / max_size);
+				P0[n] = { static_cast<base_float>(re), static_cast<base_float>(im) };
+				P0[max_size / 2 - n] = { static_cast<base_float>(im), static_cast<base_float>(re) };
+			});
+			do_loop(max_size / 2, [P0](size_t const n) {
+				P0[n + max_size / 2] = { -P0[n].imag(), P0[n].real() };
+			});
+
+			// shorter ones are sampled from the longest.
+			do_loop(max_size, [this, P0](size_t const k) {
+				if (k == 0) return;
+				size_t const S = std::bit_floor(k), n = k - S;
+				P[k] = P0[n * (max_size / S)];
+			});
+			// Q[n] = \e(n/max_size).
+			do_loop(max_size / 2, [this, P0](size_t const n) {
+				Q[n] = P0[2 * n];
+			});
+			do_loop(max_size / 2, [this](size_t const k) {
+				// the pass from `b` to `4b` needs \e(m/(4b)), \e(2m/(4b)) and \e(3m/(4b)).
+				if (k < 2) return;
+				size_t const b = std::bit_floor(k), m = k - b;
+				auto const w = stage_twiddles(b) + 6 * (m >> 1) + (m & 1);
+				auto const tilt = P + 2 * b; // \e(n/(4b)) for n < 2b.
+				w[0] = tilt[m];
+				w[2] = tilt[2 * m];
+				w[4] = 3 * m < 2 * b ? tilt[3 * m] : -tilt[3 * m - 2 * b];
+			});
+			do_loop(max_size, [this](size_t const n) {
+				R[n] = static_cast<std::remove_cvref_t<decltype(R[n])>>(detail::bit_reverse(n, max_bits));
 			});
 		}
 
 		// @return the buffer containing the image of the Fourier transform,
-		// which is either `src` or `buf`. `src` if `N` is a power of 4, `buf` otherwise.
+		// which is either `src` or `buf`.
 		template<size_t N> requires(is_size_valid(N))
 		constexpr cpx(&operator()(cpx(&src)[N], cpx(&buf)[N]) const)[N]
 		{
-			cpx(*s)[N] = &src;
-			cpx(*d)[N] = &buf;
-			for (size_t b = 1, B = max_bits - 1; b < N; b <<= 1, B--, std::swap(s, d)) {
-				do_loop(N / 2, [&, this](size_t const n) {
-					size_t const
-						m = n & (b - 1),
-						s0 = n, s1 = s0 | (N / 2),
-						d0 = ((n ^ m) << 1) | m,
-						d1 = d0 | b;
-
-					auto const t = std::conj(Q[m << B]) * (*s)[s1];
-					(*d)[d0] = (*s)[s0] + t;
-					(*d)[d1] = (*s)[s0] - t;
-				});
-			}
-
-			return *s;
+			return transform<false, codelet_size(N)>(src, buf, N) == src ? src : buf;
 		}
 		// @return the buffer containing the image of the Fourier transform,
-		// which is either `src` or `buf`. `src` if `N` is a power of 4, `buf` otherwise.
+		// which is either `src` or `buf`.
 		constexpr cpx* operator()(cpx* src, cpx* buf, size_t N) const
 		{
 			if (!is_size_valid(N)) return src;
-
-			cpx* s = src;
-			cpx* d = buf;
-			for (size_t b = 1, B = max_bits - 1; b < N; b <<= 1, B--, std::swap(s, d)) {
-				do_loop(N / 2, [&, this](size_t const n) {
-					size_t const
-						m = n & (b - 1),
-						s0 = n, s1 = s0 | (N / 2),
-						d0 = ((n ^ m) << 1) | m,
-						d1 = d0 | b;
-
-					auto const t = std::conj(Q[m << B]) * s[s1];
-					d[d0] = s[s0] + t;
-					d[d1] = s[s0] - t;
-				});
-			}
-
-			return s;
+			return dispatch<false>(src, buf, N);
 		}
 		// @brief a proxy of operator(), which operates a Fourier transform.
 		template<size_t N> requires(is_size_valid(N))
@@ -110,53 +204,562 @@ namespace sigma_lib::fft
 		constexpr auto* fwd(cpx* src, cpx* buf, size_t N) const { return (*this)(src, buf, N); }
 
 		// @return the buffer containing the image of the Fourier transform,
-		// which is either `src` or `buf`. `src` if `N` is a power of 4, `buf` otherwise.
+		// which is either `src` or `buf`.
 		template<size_t N> requires(is_size_valid(N))
 		constexpr cpx(&inv(cpx(&src)[N], cpx(&buf)[N]) const)[N]
 		{
-			cpx(*s)[N] = &src;
-			cpx(*d)[N] = &buf;
-			for (size_t b = 1, B = max_bits - 1; b < N; b <<= 1, B--, std::swap(s, d)) {
-				do_loop(N / 2, [&, this](size_t const n) {
-					size_t const
-						m = n & (b - 1),
-						s0 = n, s1 = s0 | (N / 2),
-						d0 = ((n ^ m) << 1) | m,
-						d1 = d0 | b;
-
-					auto const t = Q[m << B] * (*s)[s1];
-					(*d)[d0] = (*s)[s0] + t;
-					(*d)[d1] = (*s)[s0] - t;
-				});
-			}
-
-			return *s;
+			return transform<true, codelet_size(N)>(src, buf, N) == src ? src : buf;
 		}
 		// @return the buffer containing the image of the Fourier transform,
-		// which is either `src` or `buf`. `src` if `N` is a power of 4, `buf` otherwise.
+		// which is either `src` or `buf`.
 		constexpr cpx* inv(cpx* src, cpx* buf, size_t N) const
 		{
 			if (!is_size_valid(N)) return src;
+			return dispatch<true>(src, buf, N);
+		}
+
+		// @brief in-place variant of the Fourier transform, which needs no extra buffer.
+		// @return `data`, containing the image.
+		template<size_t N> requires(is_size_valid(N))
+		constexpr cpx(&operator()(cpx(&data)[N]) const)[N]
+		{
+			transform<false, codelet_size(N), true>(data, data, N);
+			return data;
+		}
+		// @brief in-place variant of the Fourier transform, which needs no extra buffer.
+		// @return `data`, containing the image.
+		constexpr cpx* operator()(cpx* data, size_t N) const
+		{
+			if (!is_size_valid(N)) return data;
+			return dispatch<false, true>(data, data, N);
+		}
+		// @brief a proxy of operator(), which operates a Fourier transform in place.
+		template<size_t N> requires(is_size_valid(N))
+		constexpr auto& fwd(cpx(&data)[N]) const { return (*this)(data); }
+		// @brief a proxy of operator(), which operates a Fourier transform in place.
+		constexpr auto* fwd(cpx* data, size_t N) const { return (*this)(data, N); }
+
+		// @brief in-place variant of the inverse Fourier transform, which needs no extra buffer.
+		// @return `data`, containing the image.
+		template<size_t N> requires(is_size_valid(N))
+		constexpr cpx(&inv(cpx(&data)[N]) const)[N]
+		{
+			transform<true, codelet_size(N), true>(data, data, N);
+			return data;
+		}
+		// @brief in-place variant of the inverse Fourier transform, which needs no extra buffer.
+		// @return `data`, containing the image.
+		constexpr cpx* inv(cpx* data, size_t N) const
+		{
+			if (!is_size_valid(N)) return data;
+			return dispatch<true, true>(data, data, N);
+		}
+
+		// @brief inverse Fourier transform whose image is real, of length `2N`,
+		// with the frequencies shifted by half a bin:
+		// y_n = \sum_{k<N} (X_k \e((k+1/2)n/(2N)) + c.c.), where \e(z) = exp(2 pi i z).
+		// the image is packed as {y_{2m}, y_{2m+1}} in the m-th element.
+		// `src` is overwritten.
+		// @return the buffer containing the image, which is either `src` or `buf`.
+		template<size_t N> requires(is_size_valid(N) && 4 * N <= max_size)
+		constexpr cpx(&inv_real(cpx(&src)[N], cpx(&buf)[N]) const)[N]
+		{
+			real_pre_twiddle(src, N, real_twiddles(N));
+			auto& ret = inv(src, buf);
+			real_post_twiddle(ret, N, real_twiddles(N));
+			return ret;
+		}
+		// @brief inverse Fourier transform whose image is real, of length `2N`,
+		// with the frequencies shifted by half a bin:
+		// y_n = \sum_{k<N} (X_k \e((k+1/2)n/(2N)) + c.c.), where \e(z) = exp(2 pi i z).
+		// the image is packed as {y_{2m}, y_{2m+1}} in the m-th element.
+		// `src` is overwritten.
+		// @return the buffer containing the image, which is either `src` or `buf`.
+		constexpr cpx* inv_real(cpx* src, cpx* buf, size_t N) const
+		{
+			if (!is_size_valid(N) || 4 * N > max_size) return src;
+
+			real_pre_twiddle(src, N, real_twiddles(N));
+			auto const ret = inv(src, buf, N);
+			real_post_twiddle(ret, N, real_twiddles(N));
+			return ret;
+		}
+		// @brief in-place variant of `inv_real()`, which needs no extra buffer.
+		// @return `data`, containing the image.
+		template<size_t N> requires(is_size_valid(N) && 4 * N <= max_size)
+		constexpr cpx(&inv_real(cpx(&data)[N]) const)[N]
+		{
+			real_pre_twiddle(data, N, real_twiddles(N));
+			inv(data);
+			real_post_twiddle(data, N, real_twiddles(N));
+			return data;
+		}
+		// @brief in-place variant of `inv_real()`, which needs no extra buffer.
+		// @return `data`, containing the image.
+		constexpr cpx* inv_real(cpx* data, size_t N) const
+		{
+			if (!is_size_valid(N) || 4 * N > max_size) return data;
+
+			real_pre_twiddle(data, N, real_twiddles(N));
+			inv(data, N);
+			real_post_twiddle(data, N, real_twiddles(N));
+			return data;
+		}
+		// @brief Fourier transform of real values, of length `2N`,
+		// with the frequencies shifted by half a bin:
+		// X_k = \sum_{n<2N} y_n \e(-(k+1/2)n/(2N)), where \e(z) = exp(2 pi i z).
+		// the input is packed as {y_{2m}, y_{2m+1}} in the m-th element.
+		// this is the inverse of `inv_real()` up to the factor `2N`.
+		// @return `data`, containing the image.
+		constexpr cpx* fwd_real(cpx* data, size_t N) const
+		{
+			if (!is_size_valid(N) || 4 * N > max_size) return data;
+
+			real_post_untwiddle(data, N, real_twiddles(N));
+			(*this)(data, N);
+			real_pre_untwiddle(data, N, real_twiddles(N));
+			return data;
+		}
+
+		// @brief the transforms of a fixed length, which run in place
+		// and read the tilting factors for that length from a contiguous table.
+		// lengths exceeding `max_size` are composed by the four-step algorithm,
+		// for which the plan owns the scratch, a part of which for each lane.
+		// the column groups of the four-step algorithm are independent,
+		// and may be distributed among the lanes by the `columns` loop
+		// (see `detail::flat_columns`) with the same result as the serial one.
+		class plan {
+			FFT const& fft;
+			size_t const N;
+			// \e(n/(2N)) is P[n >> shift] * F[n & mask],
+			// where `shift` is zero and `F` is not used for lengths within `max_size`.
+			cpx const* const P;
+			size_t const shift, mask;
+			// `F` followed by the scratch, only for lengths exceeding `max_size`.
+			std::unique_ptr<cpx[]> mem;
+			size_t const lanes;
+
+			// number of columns transformed at once in the four-step algorithm.
+			constexpr static size_t block = 8;
+
+			friend FFT;
+			constexpr plan(FFT const& fft, size_t N, size_t lanes)
+				: fft{ fft }, N{ N }
+				, P{ fft.P + std::min(N, max_size) }
+				, shift{ N <= max_size ? 0 : static_cast<size_t>(std::countr_zero(N / max_size)) }
+				, mask{ (N <= max_size ? 1 : N / max_size) - 1 }
+				, lanes{ std::max<size_t>(lanes, 1) }
+			{
+				if (N <= max_size) return;
+
+				auto const [N1, N2] = four_step_dims(N);
+				mem = std::make_unique<cpx[]>((mask + 1) + N + this->lanes * block * N1);
+				for (size_t b = 0; b <= mask; b++) {
+					auto const [re, im] = detail::cos_sin_pi(static_cast<double>(b) / N);
+					mem[b] = { static_cast<base_float>(re), static_cast<base_float>(im) };
+				}
+			}
+
+		public:
+			constexpr size_t size() const { return N; }
+
+			// @brief in-place Fourier transform of length `N`.
+			template<class Loop = decltype(detail::flat_columns) const&>
+			constexpr cpx* fwd(cpx* data, Loop&& columns = detail::flat_columns) const
+			{
+				return transform<false>(data, N, columns);
+			}
+			// @brief in-place inverse Fourier transform of length `N`.
+			template<class Loop = decltype(detail::flat_columns) const&>
+			constexpr cpx* inv(cpx* data, Loop&& columns = detail::flat_columns) const
+			{
+				return transform<true>(data, N, columns);
+			}
+			// @brief in-place variant of `FFT::inv_real()`, whose image is of length `N`.
+			// `data` has `N/2` elements. assumes `N >= 2`.
+			template<class Loop = decltype(detail::flat_columns) const&>
+			constexpr cpx* inv_real(cpx* data, Loop&& columns = detail::flat_columns) const
+			{
+				auto const tw = [this](size_t n) { return q(n); };
+				fft.real_pre_twiddle(data, N / 2, tw);
+				transform<true>(data, N / 2, columns);
+				fft.real_post_twiddle(data, N / 2, tw);
+				return data;
+			}
+			// @brief in-place variant of `FFT::fwd_real()`, whose source is of length `N`.
+			// `data` has `N/2` elements. assumes `N >= 2`.
+			template<class Loop = decltype(detail::flat_columns) const&>
+			constexpr cpx* fwd_real(cpx* data, Loop&& columns = detail::flat_columns) const
+			{
+				auto const tw = [this](size_t n) { return q(n); };
+				fft.real_post_untwiddle(data, N / 2, tw);
+				transform<false>(data, N / 2, columns);
+				fft.real_pre_untwiddle(data, N / 2, tw);
+				return data;
+			}
+			// @return the number of lanes the scratch is prepared for.
+			constexpr size_t num_lanes() const { return lanes; }
+
+			// @return \e(n/(2N)), for 0 <= n < N.
+			constexpr cpx q(size_t n) const
+			{
+				if (shift == 0) return P[n];
+				return P[n >> shift] * mem[n & mask];
+			}
+
+		private:
+			// splits the length `M` into N1 x N2, where N1 >= N2.
+			constexpr static std::pair<size_t, size_t> four_step_dims(size_t M)
+			{
+				size_t const bits = (std::countr_zero(M) + 1) / 2;
+				return { size_t{ 1 } << bits, M >> bits };
+			}
+
+			// \e(j/M), where `M` divides `2N` and j < M.
+			constexpr cpx unit(size_t j, size_t M) const
+			{
+				size_t const n = j * (2 * N / M);
+				return n < N ? q(n) : -q(n - N);
+			}
+
+			template<bool inverse>
+			constexpr cpx* transform(cpx* data, size_t M, auto&& columns) const
+			{
+				if (M <= max_size) return fft.dispatch<inverse, true>(data, data, M);
+				four_step<inverse>(data, M, columns);
+				return data;
+			}
 
-			cpx* s = src;
-			cpx* d = buf;
-			for (size_t b = 1, B = max_bits - 1; b < N; b <<= 1, B--, std::swap(s, d)) {
-				do_loop(N / 2, [&, this](size_t const n) {
-					size_t const
-						m = n & (b - 1),
-						s0 = n, s1 = s0 | (N / 2),
-						d0 = ((n ^ m) << 1) | m,
-						d1 = d0 | b;
-
-					auto const t = Q[m << B] * s[s1];
-					d[d0] = s[s0] + t;
-					d[d1] = s[s0] - t;
+			// the input is seen as a matrix of N2 rows and N1 columns.
+			// 1. each column is copied to a row of the scratch, transformed there,
+			//    and multiplied by \e(n1 k2/M).
+			// 2. each column of the scratch is transformed and written back to the same column.
+			// a few columns are processed at once so the strided accesses share cache lines.
+			// the groups of those columns are independent in each step,
+			// and the second step uses the scratch of the lane.
+			template<bool inverse>
+			constexpr void four_step(cpx* x, size_t M, auto&& columns) const
+			{
+				auto const [N1, N2] = four_step_dims(M);
+				size_t const w = std::min(block, N2);
+				cpx* const y = mem.get() + (mask + 1); // N1 x N2.
+
+				columns(N1 / w, [&, this](size_t const g, size_t) {
+					size_t const c = g * w;
+					for (size_t n2 = 0; n2 < N2; n2++) {
+						for (size_t i = 0; i < w; i++)
+							y[(c + i) * N2 + n2] = x[n2 * N1 + c + i];
+					}
+					for (size_t i = 0; i < w; i++) {
+						size_t const n1 = c + i;
+						auto const row = y + n1 * N2;
+						fft.dispatch<inverse, true>(row, row, N2);
+						for (size_t k2 = 1; k2 < N2; k2++)
+							row[k2] *= conj_if<!inverse>(unit(n1 * k2, M));
+					}
+				});
+
+				columns(N2 / w, [&, this](size_t const g, size_t const lane) {
+					size_t const c = g * w;
+					cpx* const t = y + M + lane * (block * N1); // w x N1.
+					for (size_t n1 = 0; n1 < N1; n1++) {
+						for (size_t i = 0; i < w; i++)
+							t[i * N1 + n1] = y[n1 * N2 + c + i];
+					}
+					for (size_t i = 0; i < w; i++)
+						fft.dispatch<inverse, true>(t + i * N1, t + i * N1, N1);
+					for (size_t k1 = 0; k1 < N1; k1++) {
+						for (size_t i = 0; i < w; i++)
+							x[k1 * N2 + c + i] = t[i * N1 + k1];
+					}
 				});
 			}
+		};
+		// @brief creates the plan for the transforms of length `N`,
+		// which must be a power of 2 not exceeding `max_size * max_size`.
+		// `lanes` is the number of threads the `columns` loop may use at once.
+		constexpr plan make_plan(size_t N, size_t lanes = 1) const { return { *this, N, lanes }; }
 
-			return s;
+	private:
+		// the first pass is done by an unrolled codelet of this size,
+		// so that the rest is covered exactly by radix-4 passes.
+		constexpr static size_t codelet_size(size_t N)
+		{
+			if (N <= 4) return N;
+			return (std::countr_zero(N) & 1) == 0 ? 16 : N >= 32 ? 32 : 8;
+		}
+		template<bool inverse, bool in_place = false>
+		constexpr cpx* dispatch(cpx* src, cpx* buf, size_t N) const
+		{
+			switch (codelet_size(N)) {
+			case 1:  return transform<inverse,  1, in_place>(src, buf, N);
+			case 2:  return transform<inverse,  2, in_place>(src, buf, N);
+			case 4:  return transform<inverse,  4, in_place>(src, buf, N);
+			case 8:  return transform<inverse,  8, in_place>(src, buf, N);
+			case 16: return transform<inverse, 16, in_place>(src, buf, N);
+			default: return transform<inverse, 32, in_place>(src, buf, N);
+			}
+		}
+
+		// Stockham auto-sort algorithm. after the pass of length `b`,
+		// the `j`-th block of length `b` holds the transform of x[j + (N/b) r], r = 0, 1, ..., b-1.
+		// the in-place variant permutes the input in the bit-reversed order first,
+		// so the `j`-th block holds the transform of x[rev(j) + (N/b) r] instead.
+		// @return the buffer containing the image, which is either `src` or `buf`.
+		template<bool inverse, size_t L, bool in_place = false>
+		constexpr cpx* transform(cpx* src, cpx* buf, size_t N) const
+		{
+			if constexpr (L == 1) return src;
+			else if constexpr (in_place) {
+				bit_reverse(src, N);
+				codelet_pass<inverse, L, true>(src, src, N);
+				for (size_t b = L; b < N; b <<= 2)
+					radix4_pass<inverse, true>(src, src, N, b);
+				return src;
+			}
+			else {
+				cpx* s = src;
+				cpx* d = buf;
+				codelet_pass<inverse, L>(s, d, N);
+				std::swap(s, d);
+				for (size_t b = L; b < N; b <<= 2, std::swap(s, d))
+					radix4_pass<inverse>(s, d, N, b);
+				return s;
+			}
+		}
+
+		constexpr void bit_reverse(cpx* x, size_t N) const
+		{
+			size_t const shift = max_bits + 1 - std::bit_width(N);
+			do_loop(N, [&, this](size_t const i) {
+				size_t const j = R[i] >> shift;
+				if (i < j) std::swap(x[i], x[j]);
+			});
+		}
+
+		// the twiddle factors of the pass from `b` to `4b`, assuming `b >= 2`.
+		// for each pair of `m` and `m+1` with even `m`, the six values
+		// \e(m/(4b)), \e((m+1)/(4b)), \e(2m/(4b)), \e(2(m+1)/(4b)), \e(3m/(4b)), \e(3(m+1)/(4b))
+		// are placed in this order.
+		constexpr cpx* stage_twiddles(size_t b) { return W + 3 * b; }
+		constexpr cpx const* stage_twiddles(size_t b) const { return W + 3 * b; }
+
+		// \e(n/max_size), or its conjugate for the forward transform.
+		template<bool inverse>
+		constexpr cpx tw(size_t n) const { return conj_if<!inverse>(Q[n]); }
+		template<bool conjugate>
+		constexpr static cpx conj_if(cpx const& z)
+		{
+			if constexpr (conjugate) return std::conj(z);
+			else return z;
+		}
+
+		// the first pass, combining `b = 1` up to `b = L` at once.
+		// the in-place variant reads each block in the bit-reversed order.
+		template<bool inverse, size_t L, bool in_place = false>
+		constexpr void codelet_pass(cpx const* s, cpx* d, size_t N) const
+		{
+			// position of the `r`-th input for the `j`-th block.
+			constexpr auto src_idx = [](size_t j, size_t r, size_t N) {
+				if constexpr (in_place) return j * L + detail::bit_reverse(r, std::bit_width(L) - 1);
+				else return j + r * (N / L);
+			};
+#ifdef SIGMA_LIB_FFT_SSE2
+			if !consteval {
+				if constexpr (simd_enabled && L % 2 == 0) {
+					if (N > L) {
+						// two adjacent blocks at once, one for each half of the register.
+						do_loop(N / L / 2, [&, this](size_t const j2) {
+							size_t const j = 2 * j2;
+							detail::cpx2 v[L];
+							[&]<size_t... r>(std::index_sequence<r...>) {
+								((v[r] = in_place ?
+									detail::cpx2::load(s + src_idx(j, r, N), s + src_idx(j + 1, r, N)) :
+									detail::cpx2::load(s + src_idx(j, r, N))), ...);
+							}(std::make_index_sequence<L>{});
+							codelet<inverse, L>(v);
+							[&]<size_t... r>(std::index_sequence<r...>) {
+								((lo_lo(v[2 * r], v[2 * r + 1]).store(d + j * L + 2 * r),
+									hi_hi(v[2 * r], v[2 * r + 1]).store(d + (j + 1) * L + 2 * r)), ...);
+							}(std::make_index_sequence<L / 2>{});
+						});
+						return;
+					}
+				}
+			}
+#endif
+			do_loop(N / L, [&, this](size_t const j) {
+				cpx v[L];
+				[&]<size_t... r>(std::index_sequence<r...>) {
+					((v[r] = s[src_idx(j, r, N)]), ...);
+				}(std::make_index_sequence<L>{});
+				codelet<inverse, L>(v);
+				[&]<size_t... r>(std::index_sequence<r...>) {
+					((d[j * L + r] = v[r]), ...);
+				}(std::make_index_sequence<L>{});
+			});
 		}
 
+		// the pass from length `b` to `4b`.
+		// the in-place variant takes the four blocks in the bit-reversed order.
+		template<bool inverse, bool in_place = false>
+		constexpr void radix4_pass(cpx const* s, cpx* d, size_t N, size_t b) const
+		{
+			auto const* const w = stage_twiddles(b);
+			// positions of the inputs for the `n`-th butterfly, whose outputs start at `d0`.
+			size_t const
+				s1 = in_place ? 2 * b : N / 4,
+				s2 = in_place ? 1 * b : N / 2,
+				s3 = in_place ? 3 * b : 3 * (N / 4);
+#ifdef SIGMA_LIB_FFT_SSE2
+			if !consteval {
+				if constexpr (simd_enabled) {
+					// two adjacent butterflies at once. assumes b >= 2.
+					do_loop(N / 8, [&, this](size_t const n2) {
+						using detail::cpx2;
+						size_t const
+							n = 2 * n2,
+							m = n & (b - 1),
+							d0 = ((n ^ m) << 2) | m;
+
+						auto const* const wm = w + 3 * m;
+						auto w1 = cpx2::load(wm), w2 = cpx2::load(wm + 2), w3 = cpx2::load(wm + 4);
+						if constexpr (!inverse) w1 = conj(w1), w2 = conj(w2), w3 = conj(w3);
+						size_t const s0 = in_place ? d0 : n;
+						auto const
+							t0 = cpx2::load(s + s0),
+							t1 = cpx2::load(s + s0 + s1) * w1,
+							t2 = cpx2::load(s + s0 + s2) * w2,
+							t3 = cpx2::load(s + s0 + s3) * w3;
+						auto const
+							u0 = t0 + t2, u1 = t0 - t2,
+							u2 = t1 + t3, u3 = detail::mul_i<inverse>(t1 - t3);
+
+						(u0 + u2).store(d + d0 + 0 * b);
+						(u1 + u3).store(d + d0 + 1 * b);
+						(u0 - u2).store(d + d0 + 2 * b);
+						(u1 - u3).store(d + d0 + 3 * b);
+					});
+					return;
+				}
+			}
+#endif
+			do_loop(N / 4, [&, this](size_t const n) {
+				size_t const
+					m = n & (b - 1),
+					d0 = ((n ^ m) << 2) | m;
+
+				size_t const s0 = in_place ? d0 : n;
+				auto const* const wm = w + 6 * (m >> 1) + (m & 1);
+				auto const
+					t0 = s[s0],
+					t1 = conj_if<!inverse>(wm[0]) * s[s0 + s1],
+					t2 = conj_if<!inverse>(wm[2]) * s[s0 + s2],
+					t3 = conj_if<!inverse>(wm[4]) * s[s0 + s3];
+				auto const
+					u0 = t0 + t2, u1 = t0 - t2,
+					u2 = t1 + t3, u3 = detail::mul_i<inverse>(t1 - t3);
+
+				d[d0 + 0 * b] = u0 + u2;
+				d[d0 + 1 * b] = u1 + u3;
+				d[d0 + 2 * b] = u0 - u2;
+				d[d0 + 3 * b] = u1 - u3;
+			});
+		}
+
+		// in-place transform of length `L` on registers, unrolled at compile time.
+		// `V` is either `cpx` or a packed type that operates on several at once.
+		template<bool inverse, size_t L, class V>
+		constexpr void codelet(V(&v)[L]) const
+		{
+			if constexpr (L == 2) {
+				auto const a = v[0], b = v[1];
+				v[0] = a + b; v[1] = a - b;
+			}
+			else if constexpr (L > 2) {
+				V e[L / 2], o[L / 2];
+				[&]<size_t... k>(std::index_sequence<k...>) {
+					((e[k] = v[2 * k], o[k] = v[2 * k + 1]), ...);
+				}(std::make_index_sequence<L / 2>{});
+				codelet<inverse, L / 2>(e);
+				codelet<inverse, L / 2>(o);
+				[&]<size_t... k>(std::index_sequence<k...>) {
+					((o[k] = rotate<inverse, k, L>(o[k]),
+						v[k] = e[k] + o[k], v[k + L / 2] = e[k] - o[k]), ...);
+				}(std::make_index_sequence<L / 2>{});
+			}
+		}
+
+		// multiplies by \e(k/L), or by its conjugate for the forward transform.
+		// trivial factors are resolved at compile time.
+		template<bool inverse, size_t k, size_t L, class V>
+		constexpr V rotate(V const& x) const
+		{
+			constexpr auto h = std::numbers::sqrt2_v<base_float> / 2;
+			using detail::mul_i;
+			if constexpr (k == 0) return x;
+			else if constexpr (4 * k == L) return mul_i<inverse>(x);
+			else if constexpr (8 * k == L) return (x + mul_i<inverse>(x)) * h;
+			else if constexpr (8 * k == 3 * L) return (mul_i<inverse>(x) - x) * h;
+			else return tw<inverse>(k * (max_size / L)) * x;
+		}
+
+		// \e(n/(4N)) for n < 2N, read from the strided table.
+		constexpr auto real_twiddles(size_t N) const
+		{
+			size_t const B = max_bits - std::bit_width(N) - 1; // \e(1/(4N)) is Q[1 << B].
+			return [this, B](size_t n) -> cpx const& { return Q[n << B]; };
+		}
+
+		// folds the spectrum so that the even-indexed samples of the image
+		// come to the real part, and the odd-indexed to the imaginary part.
+		// `tw(n)` returns \e(n/(4N)).
+		constexpr void real_pre_twiddle(cpx* X, size_t N, auto const& tw) const
+		{
+			do_loop((N + 1) / 2, [&](size_t const j) {
+				size_t const k = N - 1 - j;
+				auto const
+					a = X[j], b = X[k],
+					// \e((j+1/2)/(2N)) and \e((k+1/2)/(2N)).
+					wa = tw(2 * j + 1) * a, wb = tw(2 * k + 1) * b;
+
+				// W_j = (X_j + \bar{X_k}) + i (w_j X_j + \bar{w_k X_k}).
+				X[j] = a + std::conj(b) + cpx{ 0, 1 } * (wa + std::conj(wb));
+				X[k] = b + std::conj(a) + cpx{ 0, 1 } * (wb + std::conj(wa));
+			});
+		}
+		// tilts by `pi i m/N` to complete the half-bin shift.
+		constexpr void real_post_twiddle(cpx* y, size_t N, auto const& tw) const
+		{
+			do_loop(N, [&](size_t const m) {
+				y[m] *= tw(2 * m);
+			});
+		}
+		// the inverse of `real_post_twiddle()`.
+		constexpr void real_post_untwiddle(cpx* y, size_t N, auto const& tw) const
+		{
+			do_loop(N, [&](size_t const m) {
+				y[m] *= std::conj(tw(2 * m));
+			});
+		}
+		// the inverse of `real_pre_twiddle()`, up to the factor `2N` of the forward transform.
+		constexpr void real_pre_untwiddle(cpx* W, size_t N, auto const& tw) const
+		{
+			do_loop((N + 1) / 2, [&](size_t const j) {
+				size_t const k = N - 1 - j;
+				auto const
+					a = W[j], b = std::conj(W[k]),
+					// A = (W_j + \bar{W_k})/2, B = (W_j - \bar{W_k})/(2i),
+					// so that X_j = A + \bar{w_j} B and X_k = \bar{A - \bar{w_j} B}.
+					A = (a + b) * base_float(0.5), B = (a - b) * cpx{ 0, -0.5 },
+					wB = std::conj(tw(2 * j + 1)) * B;
+
+				W[j] = A + wB;
+				W[k] = std::conj(A - wB);
+			});
+		}
+
+	public:
 		constexpr auto const& q() const { return Q; }
 		constexpr cpx const& q(size_t i) const { return Q[i]; }
 	};
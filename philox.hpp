@@ -13,6 +13,13 @@ THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR I
 #include <cstdint>
 #include <limits>
 #include <array>
+#include <algorithm>
+#include <span>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIGMA_LIB_PHILOX_SSE2
+#endif
 
 namespace sigma_lib::rng::philox_test
 {
@@ -48,18 +55,29 @@ namespace sigma_lib::rng::philox_test
 
 	private:
 		constexpr static size_t array_size = word_count / 2; // exposition only.
-
-		template<size_t m, size_t r>
-		static consteval std::array<result_type, word_count / m> skipped_array()
+		// number of blocks generated at once, which the SIMD path processes in parallel.
+		constexpr static size_t buffer_blocks = word_size == 32 && word_count == 4 ? 8 : 1;
+		constexpr static size_t buffer_size = buffer_blocks * word_count;
+#ifdef SIGMA_LIB_PHILOX_SSE2
+		constexpr static bool simd_enabled = word_size == 32 && word_count == 4;
+		constexpr static size_t simd_blocks = 8; // two registers for each word.
+#endif
+
+		template<size_t step, size_t offset>
+		static consteval std::array<result_type, word_count / step> skipped_array()
 		{
-			std::array<result_type, word_count / m> ret{};
+			std::array<result_type, word_count / step> ret{};
 			std::array<result_type, word_count> const src{ consts... };
-			for (size_t k = 0; k < word_count / m; k++)
-				ret[k] = src[k * m + r];
+			for (size_t k = 0; k < word_count / step; k++)
+				ret[k] = src[k * step + offset];
 			return ret;
 		}
 
 	public:
+		// types of the stateless interface.
+		using key_type = std::array<result_type, array_size>;
+		using block_type = std::array<result_type, word_count>; // also used for counters, the lowest word first.
+
 		constexpr static std::array<result_type, array_size> multipliers = skipped_array<2, 0>();
 		constexpr static std::array<result_type, array_size> round_consts = skipped_array<2, 1>();
 		static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
@@ -83,7 +101,7 @@ namespace sigma_lib::rng::philox_test
 
 			// reset X and i.
 			X = {};
-			i = word_count - 1;
+			i = buffer_size - 1;
 		}
 		template<class seed_seq> constexpr void seed(seed_seq& q)
 		{
@@ -92,7 +110,7 @@ namespace sigma_lib::rng::philox_test
 
 			// reset X and i.
 			X = {};
-			i = word_count - 1;
+			i = buffer_size - 1;
 		}
 
 		constexpr void set_counter(std::array<result_type, word_count> const& counter)
@@ -100,6 +118,40 @@ namespace sigma_lib::rng::philox_test
 			std::copy(counter.rbegin(), counter.rend(), X);
 		}
 
+		// stateless interface, computing any block independently.
+		/// @brief the key that `seed(value)` sets.
+		static constexpr key_type make_key(result_type value)
+		{
+			key_type ret{};
+			ret[0] = value;
+			return ret;
+		}
+		constexpr key_type const& key() const { return K; }
+		/// @brief the block for the counter `counter` under the key `key`.
+		/// an engine with the key and the initial counter returns the words of the block
+		/// for Z = `counter` by its calls from (Z * word_count)-th to ((Z + 1) * word_count - 1)-th,
+		/// counting from zero.
+		static constexpr block_type block(key_type const& key, block_type counter)
+		{
+			for (size_t q = 0; q < round_count; q++)
+				philox_round(counter, key, q);
+			return counter;
+		}
+		static constexpr block_type block(key_type const& key, uint64_t z)
+		{
+			block_type counter{};
+			for (size_t j = 0; j < word_count && z > 0; j++) {
+				counter[j] = static_cast<result_type>(z);
+				z = word_size < 64 ? z >> (word_size % 64) : 0;
+			}
+			return block(key, counter);
+		}
+		/// @brief the value that an engine with the key and the initial counter returns after discarding `t` values.
+		static constexpr result_type value(key_type const& key, uint64_t t)
+		{
+			return block(key, t / word_count)[t % word_count];
+		}
+
 		// equality operators
 		constexpr bool operator==(philox_engine_test const& other) const
 		{
@@ -110,71 +162,176 @@ namespace sigma_lib::rng::philox_test
 		constexpr result_type operator()()
 		{
 			i++;
-			if (i == word_count) {
-				Philox();
-
-				increment_Z();
+			if (i == buffer_size) {
+				Philox(Y.data(), buffer_blocks);
 				i = 0;
 			}
 
 			// return the generated value.
 			return Y[i];
 		}
+		// fills `dst` with the values that the same number of calls to operator() would return.
+		constexpr void generate(std::span<result_type> dst)
+		{
+			size_t k = 0;
+			auto const len = dst.size();
+
+			// the rest of the buffer.
+			for (; k < len && i + 1 < buffer_size; k++) dst[k] = Y[++i];
+
+			// whole blocks directly to the destination.
+			auto const blocks = (len - k) / word_count;
+			Philox(dst.data() + k, blocks);
+			k += blocks * word_count;
+
+			// the remainder through the buffer.
+			for (; k < len; k++) dst[k] = (*this)();
+		}
 		constexpr void discard(uint64_t z)
 		{
 			z += i;
-			if (z < word_count) {
+			if (z < buffer_size) {
 				// discarding small amount.
 				i = static_cast<size_t>(z);
 				return;
 			}
 
 			// calculate the rest.
-			i = z % word_count;
-			z /= word_count;
+			i = z % buffer_size;
+			z /= buffer_size;
 
-			if (i != word_count - 1) z--; // operator() calls Philox() *before* Z increments.
-
-			// add to Z.
-			for (size_t j = 0; j < word_count && z > 0; j++) {
-				auto z0 = static_cast<result_type>(z);
-				z >>= word_size;
-				if ((X[j] += z0) < z0) z++;
-			}
+			if (i != buffer_size - 1) z--; // operator() calls Philox() *before* Z increments.
+			add_Z(z * buffer_blocks);
 
 			// generate Y if necessary.
-			if (i != word_count - 1) {
-				Philox();
-				increment_Z(); // do the pended increment.
-			}
+			if (i != buffer_size - 1)
+				Philox(Y.data(), buffer_blocks); // do the pended increment.
 		}
 
 	private:
 		// implementations of PRNG.
 		std::array<result_type, array_size> K; // "key" sequence (essentially a seed).
 		std::array<result_type, word_count> X; // represents a big integer Z = \sum_j 2^{w j} X_j.
-		std::array<result_type, word_count> Y; // generated sequence.
+		std::array<result_type, buffer_size> Y; // generated sequence of `buffer_blocks` blocks.
 		size_t i = 0;
 
 		constexpr void increment_Z() {
 			for (size_t j = 0; j < word_count && ++X[j] == 0; ++j);
 		}
+		constexpr void add_Z(uint64_t z) {
+			for (size_t j = 0; j < word_count && z > 0; j++) {
+				auto z0 = static_cast<result_type>(z);
+				z = word_size < 64 ? z >> (word_size % 64) : 0;
+				if ((X[j] += z0) < z0) z++;
+			}
+		}
 
-		constexpr void Philox()
+		// writes `blocks` blocks to `dst`, incrementing Z for each.
+		constexpr void Philox(result_type* dst, size_t blocks)
 		{
-			Y = X;
-			for (size_t q = 0; q < round_count; q++)
-				philox_round(q);
+#ifdef SIGMA_LIB_PHILOX_SSE2
+			if !consteval {
+				if constexpr (simd_enabled) {
+					for (; blocks >= simd_blocks; blocks -= simd_blocks, dst += simd_blocks * word_count)
+						philox_simd(dst);
+				}
+			}
+#endif
+			for (; blocks > 0; blocks--, dst += word_count) {
+				auto const Y = block(K, X);
+				std::copy(Y.begin(), Y.end(), dst);
+				increment_Z();
+			}
 		}
-		constexpr void philox_round(size_t q)
+		static constexpr void philox_round(block_type& Y, key_type const& key, size_t q)
 		{
 			auto const V = permute(Y);
 
 			for (size_t k = 0; k < array_size; k++) {
 				mul_lo_hi(Y[2 * k], Y[2 * k + 1], V[2 * k + 1], multipliers[k]);
-				Y[2 * k + 1] ^= (K[k] + q * round_consts[k]) ^ V[2 * k];
+				Y[2 * k + 1] ^= (key[k] + q * round_consts[k]) ^ V[2 * k];
+			}
+		}
+
+#ifdef SIGMA_LIB_PHILOX_SSE2
+		// 32 x 32 -> 64 bit products of four lanes, split into the lower and the higher halves.
+		static void mul_lo_hi(__m128i& lo, __m128i& hi, __m128i a, __m128i b)
+		{
+			auto const
+				even = _mm_shuffle_epi32(_mm_mul_epu32(a, b), _MM_SHUFFLE(3, 1, 2, 0)),
+				odd = _mm_shuffle_epi32(_mm_mul_epu32(_mm_srli_epi64(a, 32), b), _MM_SHUFFLE(3, 1, 2, 0));
+			lo = _mm_unpacklo_epi32(even, odd);
+			hi = _mm_unpackhi_epi32(even, odd);
+		}
+
+		// `simd_blocks` blocks at once, each register holding the same word of four blocks.
+		void philox_simd(result_type* dst)
+		{
+			constexpr size_t G = simd_blocks / 4;
+			__m128i y[G][word_count];
+			if (static_cast<uint32_t>(X[0]) <= std::numeric_limits<uint32_t>::max() - simd_blocks) {
+				// no carries; only the lowest words differ.
+				for (size_t g = 0; g < G; g++) {
+					y[g][0] = _mm_add_epi32(_mm_set1_epi32(static_cast<int32_t>(X[0] + 4 * g)),
+						_mm_setr_epi32(0, 1, 2, 3));
+					for (size_t j = 1; j < word_count; j++)
+						y[g][j] = _mm_set1_epi32(static_cast<int32_t>(X[j]));
+				}
+				X[0] += simd_blocks;
+			}
+			else {
+				for (size_t g = 0; g < G; g++) {
+					alignas(16) uint32_t c[word_count][4];
+					for (size_t b = 0; b < 4; b++) {
+						for (size_t j = 0; j < word_count; j++) c[j][b] = static_cast<uint32_t>(X[j]);
+						increment_Z();
+					}
+					for (size_t j = 0; j < word_count; j++)
+						y[g][j] = _mm_load_si128(reinterpret_cast<__m128i const*>(c[j]));
+				}
+			}
+
+			auto const
+				m0 = _mm_set1_epi32(static_cast<int32_t>(multipliers[0])),
+				m1 = _mm_set1_epi32(static_cast<int32_t>(multipliers[1]));
+			for (size_t q = 0; q < round_count; q++) {
+				auto const
+					k0 = _mm_set1_epi32(static_cast<int32_t>(K[0] + q * round_consts[0])),
+					k1 = _mm_set1_epi32(static_cast<int32_t>(K[1] + q * round_consts[1]));
+				for (size_t g = 0; g < G; g++) {
+					// the same as philox_round(), where V = { Y0, Y3, Y2, Y1 }.
+					__m128i lo0, hi0, lo1, hi1;
+					mul_lo_hi(lo0, hi0, y[g][3], m0);
+					mul_lo_hi(lo1, hi1, y[g][1], m1);
+					y[g][1] = _mm_xor_si128(_mm_xor_si128(hi0, k0), y[g][0]);
+					y[g][3] = _mm_xor_si128(_mm_xor_si128(hi1, k1), y[g][2]);
+					y[g][0] = lo0;
+					y[g][2] = lo1;
+				}
+			}
+
+			// transpose back to the sequence of blocks.
+			for (size_t g = 0; g < G; g++) {
+				auto const
+					t0 = _mm_unpacklo_epi32(y[g][0], y[g][1]), t1 = _mm_unpacklo_epi32(y[g][2], y[g][3]),
+					t2 = _mm_unpackhi_epi32(y[g][0], y[g][1]), t3 = _mm_unpackhi_epi32(y[g][2], y[g][3]);
+				__m128i const blocks[] = {
+					_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+					_mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3),
+				};
+				for (size_t b = 0; b < 4; b++) {
+					auto const d = dst + (4 * g + b) * word_count;
+					if constexpr (sizeof(result_type) == sizeof(uint32_t))
+						_mm_storeu_si128(reinterpret_cast<__m128i*>(d), blocks[b]);
+					else {
+						alignas(16) uint32_t words[word_count];
+						_mm_store_si128(reinterpret_cast<__m128i*>(words), blocks[b]);
+						std::copy(words, words + word_count, d);
+					}
+				}
 			}
 		}
+#endif
 
 		static constexpr std::array<result_type, 2> permute(std::array<result_type, 2> const& X) {
 			return X;
@@ -244,10 +401,15 @@ namespace sigma_lib::rng::philox_test
 		}
 	};
 
-	using philox4x32 = philox_engine_test<uint_fast32_t, 32, 4, 10, 0xD2511F53, 0x9E3779B9, 0xCD9E8D57, 0xBB67AE85>;
-	using philox4x64 = philox_engine_test<uint_fast64_t, 64, 4, 10, 0xD2E7470EE14C6C93, 0x9E3779B97F4A7C15, 0xCA5A826395121157, 0xBB67AE8584CAA73B>;
+	// the exact-width types, which are the same as `uint_fast32_t` and `uint_fast64_t` on MSVC.
+	using philox4x32 = philox_engine_test<uint32_t, 32, 4, 10, 0xD2511F53, 0x9E3779B9, 0xCD9E8D57, 0xBB67AE85>;
+	using philox4x64 = philox_engine_test<uint64_t, 64, 4, 10, 0xD2E7470EE14C6C93, 0x9E3779B97F4A7C15, 0xCA5A826395121157, 0xBB67AE8584CAA73B>;
+	// reduced rounds, the fewest that pass BigCrush according to the authors of Random123.
+	using philox4x32_7 = philox_engine_test<uint32_t, 32, 4, 7, 0xD2511F53, 0x9E3779B9, 0xCD9E8D57, 0xBB67AE85>;
 	/*
-	Required behaviors, which do NOT satisfy for some reason unknown:
+	Required behaviors, which do NOT satisfy;
+	the rounds differ from P2075 by the order of the multipliers and of the words in each pair,
+	which is kept for the compatibility of the generated noises (see `kat` below).
 		philox4x32:
 			The 10000th consecutive invocation of a default-constructed object of type
 			philox4x32 produces the value 1955073260.
@@ -256,4 +418,65 @@ namespace sigma_lib::rng::philox_test
 			The 10000th consecutive invocation of a default-constructed object of type
 			philox4x64 produces the value 3409172418970261260.
 	*/
+
+	// known-answer tests.
+	namespace kat
+	{
+		// Random123 (https://github.com/DEShawResearch/random123), with its published test vectors,
+		// has the same rounds as the engines with the two multipliers exchanged,
+		// when the two words of each pair are swapped in the counter and the block.
+		template<class engine>
+		constexpr bool random123(typename engine::key_type const& key,
+			typename engine::block_type const& counter, typename engine::block_type const& expected)
+		{
+			auto swap_pairs = [](typename engine::block_type x) {
+				for (size_t j = 0; j < x.size(); j += 2) std::swap(x[j], x[j + 1]);
+				return x;
+			};
+			return engine::block(key, swap_pairs(counter)) == swap_pairs(expected);
+		}
+		using r123_4x32 = philox_engine_test<uint32_t, 32, 4, 10, 0xCD9E8D57, 0x9E3779B9, 0xD2511F53, 0xBB67AE85>;
+		using r123_4x64 = philox_engine_test<uint64_t, 64, 4, 10, 0xCA5A826395121157, 0x9E3779B97F4A7C15, 0xD2E7470EE14C6C93, 0xBB67AE8584CAA73B>;
+
+		static_assert(random123<r123_4x32>({ 0, 0 }, { 0, 0, 0, 0 },
+			{ 0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8 }));
+		static_assert(random123<r123_4x32>({ 0xffffffff, 0xffffffff }, { 0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff },
+			{ 0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd }));
+		static_assert(random123<r123_4x32>({ 0xa4093822, 0x299f31d0 }, { 0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344 },
+			{ 0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1 }));
+		static_assert(random123<r123_4x64>({ 0, 0 }, { 0, 0, 0, 0 },
+			{ 0x16554d9eca36314c, 0xdb20fe9d672d0fdc, 0xd7e772cee186176b, 0x7e68b68aec7ba23b }));
+		static_assert(random123<r123_4x64>({ 0xffffffffffffffff, 0xffffffffffffffff },
+			{ 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff, 0xffffffffffffffff },
+			{ 0x87b092c3013fe90b, 0x438c3c67be8d0224, 0x9cc7d7c69cd777b6, 0xa09caebf594f0ba0 }));
+		static_assert(random123<r123_4x64>({ 0x452821e638d01377, 0xbe5466cf34e90c6c },
+			{ 0x243f6a8885a308d3, 0x13198a2e03707344, 0xa4093822299f31d0, 0x082efa98ec4e6c89 },
+			{ 0xa528f45403e61d95, 0x38c72dbd566e9788, 0xa5a1610e72fd18b5, 0x57bd43b5e52b7fe6 }));
+
+		// the blocks containing the 10000th values of the required behaviors of P2075.
+		static_assert(random123<r123_4x32>(r123_4x32::make_key(20111115u), { 2499, 0, 0, 0 },
+			{ 0xdc51a4fa, 0x600c3776, 0x79458282, 1955073260u }));
+		static_assert(random123<r123_4x64>(r123_4x64::make_key(20111115u), { 2499, 0, 0, 0 },
+			{ 0x3efb24748fe5dfa3, 0x79326545cd63d7f2, 0x98af699368347a72, 3409172418970261260u }));
+
+		// the values of the engines themselves, which the generated noises depend on.
+		static_assert(philox4x32::block(philox4x32::make_key(0), 0) ==
+			philox4x32::block_type{ 0xbab3ff0d, 0x183052d1, 0x99ac9ee8, 0xedc14406 });
+		static_assert(philox4x32::value(philox4x32::make_key(philox4x32::default_seed), 9999) == 1026757194u);
+		static_assert(philox4x64::value(philox4x64::make_key(philox4x64::default_seed), 9999) == 3358228250572627870u);
+
+		// the engines agree with the stateless interface.
+		template<class engine>
+		constexpr bool engine_agrees(typename engine::result_type seed, uint64_t t)
+		{
+			engine e{ seed };
+			e.discard(t);
+			return e() == engine::value(engine::make_key(seed), t) &&
+				e() == engine::value(engine::make_key(seed), t + 1);
+		}
+		static_assert(engine_agrees<philox4x32>(12345, 0));
+		static_assert(engine_agrees<philox4x32>(12345, 31));
+		static_assert(engine_agrees<philox4x32>(12345, 1000003));
+		static_assert(engine_agrees<philox4x64>(12345, 1000003));
+	}
 }
@@ -0,0 +1,100 @@
+/*
+The MIT License (MIT)
+
+Copyright (c) 2025 sigma-axis
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the “Software”), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED “AS IS”, WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#include <cstdint>
+#include <limits>
+#include <span>
+
+namespace sigma_lib::rng::squares
+{
+	/// @brief counter-based generator by squaring, 32-bit output with four rounds.
+	///
+	/// B. Widynski, "Squares: A Fast Counter-Based RNG", https://arxiv.org/abs/2004.06278
+	///
+	/// the interface follows a subset of the random number engines,
+	/// with the stateless `value()` for random access.
+	struct squares32 {
+		// types
+		using result_type = uint32_t;
+
+		static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+		static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+		constexpr static result_type default_seed = 20111115u;
+
+		// constructors and seeding functions
+		constexpr squares32() : squares32(default_seed) {}
+		constexpr explicit squares32(result_type value)
+		{
+			seed(value);
+		}
+		constexpr void seed(result_type value = default_seed)
+		{
+			key = make_key(value);
+			ctr = 0;
+		}
+
+		// equality operators
+		constexpr bool operator==(squares32 const& other) const = default;
+
+		// generating functions
+		constexpr result_type operator()() { return value(key, ctr++); }
+		// fills `dst` with the values that the same number of calls to operator() would return.
+		constexpr void generate(std::span<result_type> dst)
+		{
+			for (auto& x : dst) x = value(key, ctr++);
+		}
+		constexpr void discard(uint64_t z) { ctr += z; }
+
+		// stateless interface.
+		static constexpr result_type value(uint64_t key, uint64_t ctr)
+		{
+			uint64_t x = ctr * key, y = x, z = y + key;
+			x = x * x + y; x = (x >> 32) | (x << 32);
+			x = x * x + z; x = (x >> 32) | (x << 32);
+			x = x * x + y; x = (x >> 32) | (x << 32);
+			return static_cast<result_type>((x * x + z) >> 32);
+		}
+		/// @brief derives a key from `value`, in the manner of the key generator by the author:
+		/// each half of 8 hexadecimal digits consists of distinct nonzero digits, and the key is odd.
+		static constexpr uint64_t make_key(result_type value)
+		{
+			// splitmix64 as the source of the shuffles.
+			uint64_t state = value;
+			auto next = [&] {
+				uint64_t z = (state += 0x9e3779b97f4a7c15uLL);
+				z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9uLL;
+				z = (z ^ (z >> 27)) * 0x94d049bb133111ebuLL;
+				return z ^ (z >> 31);
+			};
+
+			uint64_t ret = 0;
+			for (int half = 0; half < 2; half++) {
+				uint8_t digits[15];
+				for (uint8_t d = 0; d < 15; d++) digits[d] = d + 1;
+				// partial Fisher-Yates shuffle for 8 digits.
+				for (int k = 0; k < 8; k++) {
+					auto j = k + static_cast<int>(next() % (15 - k));
+					if (half == 1 && k == 7) {
+						// the last digit from the remaining odd ones, at least one of which is left.
+						while (digits[j] % 2 == 0) j = j < 14 ? j + 1 : k;
+					}
+					auto const d = digits[j]; digits[j] = digits[k]; digits[k] = d;
+					ret = (ret << 4) | d;
+				}
+			}
+			return ret;
+		}
+
+	private:
+		uint64_t key, ctr;
+	};
+}